@@ -2,18 +2,23 @@
 #include "Constants.h"
 #include "Math.h"
 #include "Game.h"
+#include "JobSystem.h"
 
 namespace ApplesGame
 {
     void InitializeApples(std::vector<Apple>& apples, const Game& game)
     {
         apples.resize(game.applesAmount);
+        const bool isOverlapAllowed = IsAppleOverlapAllowed(game);
 
         for (int i = 0; i < game.applesAmount; ++i)
         {
             apples[i].isEaten = false;
             SetRandomColliderPosition(apples[i].position, SCREEN_WIDTH, SCREEN_HEIGHT);
-            apples[i].radius = 10.0f;
+            apples[i].radius = APPLE_RADIUS;
+
+            if (isOverlapAllowed)
+                continue;
 
             bool isCollisionFree = true;
 
@@ -29,27 +34,35 @@ namespace ApplesGame
                 }
             }
 
-            if (isCollisionFree)
-            {
-                SetApplePosition(apples[i]);
-                apples[i].sprite.setTexture(game.appleTexture);
-                SetSpriteSize(apples[i].sprite, apples[i].radius * 2.f, apples[i].radius * 2.f);
-                SetSpriteRelativeOrigin(apples[i].sprite, 0.5f, 0.5f);
-            }
-            else
-            {
+            if (!isCollisionFree)
                 --i;
-            }
         }
     }
 
-    void SetApplePosition(Apple& apple)
+    bool IsAppleOverlapAllowed(const Game& game)
+    {
+        return game.applesAmount > NON_OVERLAPPING_APPLES_MAX;
+    }
+
+    void InitializeApplesBatch(SpriteBatch& batch, const std::vector<Apple>& apples, const sf::IntRect& textureRect)
     {
-        apple.sprite.setPosition(apple.position.x, apple.position.y);
+        InitializeSpriteBatch(batch, apples.size(), sf::VertexBuffer::Dynamic);
+
+        // A freshly initialized batch is uploaded whole, so filling its quads never touches the shared dirty list
+        ParallelFor(GetJobSystem(), apples.size(), SPRITE_QUAD_COST, [&batch, &apples, &textureRect](const size_t begin, const size_t end)
+            {
+                for (size_t i = begin; i < end; ++i)
+                {
+                    SetSpriteBatchQuadTexture(batch, i, textureRect);
+                    UpdateAppleQuad(batch, apples[i], i);
+                }
+            });
     }
 
-    void DrawApple(const Apple& apple, sf::RenderWindow& window)
+    void UpdateAppleQuad(SpriteBatch& batch, const Apple& apple, const size_t index)
     {
-        window.draw(apple.sprite);
+        // Eaten apples collapse into a degenerate quad so indices stay stable
+        const float radius = apple.isEaten ? 0.f : apple.radius;
+        SetSpriteBatchQuadBounds(batch, index, {apple.position.x - radius, apple.position.y - radius, radius * 2.f, radius * 2.f});
     }
 }
@@ -2,6 +2,7 @@
 #include <SFML/Graphics.hpp>
 #include <vector>
 #include "Math.h"
+#include "SpriteBatch.h"
 
 namespace ApplesGame
 {
@@ -10,10 +11,11 @@ namespace ApplesGame
     struct Apple : Circle
     {
         bool isEaten = false;
-        sf::Sprite sprite;
     };
 
     void InitializeApples(std::vector<Apple>& apples, const Game& game);
-    void SetApplePosition(Apple& apple);
-    void DrawApple(const Apple& apple, sf::RenderWindow& window);
+    // Stress fields hold more apples than fit side by side, they are scattered freely and rocks ignore them
+    bool IsAppleOverlapAllowed(const Game& game);
+    void InitializeApplesBatch(SpriteBatch& batch, const std::vector<Apple>& apples, const sf::IntRect& textureRect);
+    void UpdateAppleQuad(SpriteBatch& batch, const Apple& apple, size_t index);
 }
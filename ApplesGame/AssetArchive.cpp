@@ -0,0 +1,166 @@
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include "AssetArchive.h"
+
+namespace ApplesGame
+{
+    namespace
+    {
+        // Layout: magic, version, entries count, then per entry name length, name, offset and size, then the data
+        constexpr char ARCHIVE_MAGIC[4] = {'A', 'P', 'A', 'K'};
+        constexpr uint32_t ARCHIVE_VERSION = 1;
+        constexpr uint64_t DATA_ALIGNMENT = 16;
+
+        template <typename Value>
+        bool ReadValue(const AssetArchive& archive, size_t& position, Value& value)
+        {
+            if (archive.file.size - position < sizeof(Value))
+                return false;
+
+            std::memcpy(&value, archive.file.data + position, sizeof(Value));
+            position += sizeof(Value);
+            return true;
+        }
+
+        template <typename Value>
+        void WriteValue(std::ofstream& file, const Value& value)
+        {
+            file.write(reinterpret_cast<const char*>(&value), sizeof(Value));
+        }
+
+        bool ReadTableOfContents(AssetArchive& archive)
+        {
+            size_t position = sizeof(ARCHIVE_MAGIC);
+            uint32_t version = 0;
+            uint32_t entriesCount = 0;
+
+            if (archive.file.size < sizeof(ARCHIVE_MAGIC) || std::memcmp(archive.file.data, ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC)) != 0 ||
+                !ReadValue(archive, position, version) || version != ARCHIVE_VERSION ||
+                !ReadValue(archive, position, entriesCount))
+            {
+                return false;
+            }
+
+            for (uint32_t i = 0; i < entriesCount; ++i)
+            {
+                uint32_t nameLength = 0;
+                if (!ReadValue(archive, position, nameLength) || archive.file.size - position < nameLength)
+                    return false;
+
+                const std::string name(reinterpret_cast<const char*>(archive.file.data + position), nameLength);
+                position += nameLength;
+
+                AssetArchiveEntry entry;
+                if (!ReadValue(archive, position, entry.offset) || !ReadValue(archive, position, entry.size) ||
+                    entry.offset > archive.file.size || entry.size > archive.file.size - entry.offset)
+                {
+                    return false;
+                }
+
+                archive.entries[name] = entry;
+            }
+
+            return true;
+        }
+    }
+
+    bool OpenAssetArchive(AssetArchive& archive, const std::string& path)
+    {
+        CloseAssetArchive(archive);
+
+        if (OpenMappedFile(archive.file, path) && ReadTableOfContents(archive))
+            return true;
+
+        CloseAssetArchive(archive);
+        return false;
+    }
+
+    void CloseAssetArchive(AssetArchive& archive)
+    {
+        CloseMappedFile(archive.file);
+        archive.entries.clear();
+    }
+
+    bool FindArchivedAsset(const AssetArchive& archive, const std::string& name, const void*& data, size_t& size)
+    {
+        const auto entry = archive.entries.find(name);
+        if (entry == archive.entries.end())
+            return false;
+
+        data = archive.file.data + entry->second.offset;
+        size = static_cast<size_t>(entry->second.size);
+        return true;
+    }
+
+    bool WriteAssetArchive(const std::string& path, const std::string& rootDirectory, const std::vector<std::string>& names,
+                           std::string& error)
+    {
+        std::vector<std::vector<char>> contents(names.size());
+
+        for (size_t i = 0; i < names.size(); ++i)
+        {
+            std::ifstream sourceFile(rootDirectory + "/" + names[i], std::ios::binary);
+            if (!sourceFile)
+            {
+                error = "Failed to read " + rootDirectory + "/" + names[i];
+                return false;
+            }
+
+            contents[i].assign(std::istreambuf_iterator<char>(sourceFile), std::istreambuf_iterator<char>());
+        }
+
+        uint64_t tableSize = sizeof(ARCHIVE_MAGIC) + sizeof(uint32_t) * 2;
+        for (const std::string& name : names)
+            tableSize += sizeof(uint32_t) + name.size() + sizeof(uint64_t) * 2;
+
+        std::vector<uint64_t> offsets(names.size());
+        uint64_t offset = tableSize;
+        for (size_t i = 0; i < names.size(); ++i)
+        {
+            offset = (offset + DATA_ALIGNMENT - 1) / DATA_ALIGNMENT * DATA_ALIGNMENT;
+            offsets[i] = offset;
+            offset += contents[i].size();
+        }
+
+        std::ofstream archiveFile(path, std::ios::binary | std::ios::trunc);
+        if (!archiveFile)
+        {
+            error = "Failed to create " + path;
+            return false;
+        }
+
+        archiveFile.write(ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC));
+        WriteValue(archiveFile, ARCHIVE_VERSION);
+        WriteValue(archiveFile, static_cast<uint32_t>(names.size()));
+
+        for (size_t i = 0; i < names.size(); ++i)
+        {
+            WriteValue(archiveFile, static_cast<uint32_t>(names[i].size()));
+            archiveFile.write(names[i].data(), names[i].size());
+            WriteValue(archiveFile, offsets[i]);
+            WriteValue(archiveFile, static_cast<uint64_t>(contents[i].size()));
+        }
+
+        for (size_t i = 0; i < names.size(); ++i)
+        {
+            const std::vector<char> padding(static_cast<size_t>(offsets[i] - static_cast<uint64_t>(archiveFile.tellp())), 0);
+            archiveFile.write(padding.data(), padding.size());
+            archiveFile.write(contents[i].data(), contents[i].size());
+        }
+
+        if (!archiveFile)
+        {
+            error = "Failed to write " + path;
+            return false;
+        }
+
+        return true;
+    }
+
+    AssetArchive& GetMountedAssetArchive()
+    {
+        static AssetArchive archive;
+        return archive;
+    }
+}
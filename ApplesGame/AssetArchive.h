@@ -0,0 +1,28 @@
+#pragma once
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "MappedFile.h"
+
+namespace ApplesGame
+{
+    struct AssetArchiveEntry
+    {
+        uint64_t offset = 0;
+        uint64_t size = 0;
+    };
+
+    // Read-only view of a packed archive mapped into memory, entries point straight into the mapping
+    struct AssetArchive
+    {
+        MappedFile file;
+        std::unordered_map<std::string, AssetArchiveEntry> entries;
+    };
+
+    bool OpenAssetArchive(AssetArchive& archive, const std::string& path);
+    void CloseAssetArchive(AssetArchive& archive);
+    bool FindArchivedAsset(const AssetArchive& archive, const std::string& name, const void*& data, size_t& size);
+    bool WriteAssetArchive(const std::string& path, const std::string& rootDirectory, const std::vector<std::string>& names,
+                           std::string& error);
+    AssetArchive& GetMountedAssetArchive();
+}
@@ -0,0 +1,73 @@
+#include "AssetLoader.h"
+#include "Constants.h"
+#include "ResourceCache.h"
+
+namespace ApplesGame
+{
+    namespace
+    {
+        template <typename Resource>
+        void StartLoadingTask(AssetLoader& loader, ResourceCache<Resource>& cache, const std::string& path)
+        {
+            loader.paths.push_back(path);
+            loader.tasks.push_back(std::async(std::launch::async, [&loader, &cache, path]()
+                {
+                    const std::shared_ptr<const void> resource = AcquireResource(cache, path);
+
+                    const sf::Int64 finishMicroseconds = loader.clock.getElapsedTime().asMicroseconds();
+                    sf::Int64 loadingMicroseconds = loader.loadingMicroseconds;
+                    while (finishMicroseconds > loadingMicroseconds &&
+                        !loader.loadingMicroseconds.compare_exchange_weak(loadingMicroseconds, finishMicroseconds))
+                    {
+                    }
+
+                    ++loader.finishedTasksCount;
+                    return resource;
+                }));
+        }
+    }
+
+    void StartAssetLoading(AssetLoader& loader)
+    {
+        loader.clock.restart();
+
+        for (const std::string& textureName : ATLAS_TEXTURE_NAMES)
+            StartLoadingTask(loader, GetImageCache(), RESOURCES_PATH + textureName);
+
+        StartLoadingTask(loader, GetSoundBufferCache(), RESOURCES_PATH + EAT_SOUND_NAME);
+        StartLoadingTask(loader, GetSoundBufferCache(), RESOURCES_PATH + DEATH_SOUND_NAME);
+        StartLoadingTask(loader, GetFontCache(), RESOURCES_PATH + FONT_NAME);
+    }
+
+    float GetAssetLoadingProgress(const AssetLoader& loader)
+    {
+        return loader.tasks.empty() ? 1.f : static_cast<float>(loader.finishedTasksCount) / static_cast<float>(loader.tasks.size());
+    }
+
+    bool IsAssetLoadingFinished(const AssetLoader& loader)
+    {
+        return loader.finishedTasksCount == static_cast<int>(loader.tasks.size());
+    }
+
+    bool FinishAssetLoading(AssetLoader& loader)
+    {
+        for (size_t i = 0; i < loader.tasks.size(); ++i)
+        {
+            std::shared_ptr<const void> asset = loader.tasks[i].get();
+
+            if (asset)
+                loader.assets.push_back(std::move(asset));
+            else
+                loader.errors.push_back("Failed to load " + loader.paths[i]);
+        }
+
+        loader.tasks.clear();
+        return loader.errors.empty();
+    }
+
+    void ReleaseLoadedAssets(AssetLoader& loader)
+    {
+        loader.assets.clear();
+        loader.assets.shrink_to_fit();
+    }
+}
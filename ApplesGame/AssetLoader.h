@@ -0,0 +1,33 @@
+#pragma once
+#include <SFML/System/Clock.hpp>
+#include <atomic>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ApplesGame
+{
+    // Decodes every asset on worker threads into the resource caches, the synchronous loads that follow only hit the caches
+    struct AssetLoader
+    {
+        std::vector<std::string> paths;
+        std::vector<std::future<std::shared_ptr<const void>>> tasks;
+        std::atomic<int> finishedTasksCount{0};
+
+        // Time from StartAssetLoading until the slowest task finished
+        sf::Clock clock;
+        std::atomic<sf::Int64> loadingMicroseconds{0};
+
+        // Keeps loaded assets alive until their users acquire them from the caches
+        std::vector<std::shared_ptr<const void>> assets;
+        std::vector<std::string> errors;
+    };
+
+    void StartAssetLoading(AssetLoader& loader);
+    float GetAssetLoadingProgress(const AssetLoader& loader);
+    bool IsAssetLoadingFinished(const AssetLoader& loader);
+    bool FinishAssetLoading(AssetLoader& loader);
+    // Call once every user has acquired its assets, from then on the caches free each asset with its last holder
+    void ReleaseLoadedAssets(AssetLoader& loader);
+}
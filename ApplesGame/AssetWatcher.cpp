@@ -0,0 +1,298 @@
+#include <SFML/System/Clock.hpp>
+#include <algorithm>
+#include <iostream>
+#include "AssetWatcher.h"
+#include "Constants.h"
+#include "ResourceCache.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#elif defined(__linux__)
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace ApplesGame
+{
+    namespace
+    {
+        constexpr int CHANGES_WAIT_MILLISECONDS = 100;
+
+        // Editors often save in several writes, an asset is reloaded once it has been quiet for this long
+        constexpr float RELOAD_SETTLE_SECONDS = 0.1f;
+        constexpr int RELOAD_ATTEMPTS = 5;
+
+        struct PendingReload
+        {
+            sf::Clock sinceChange;
+            int attemptsLeft = RELOAD_ATTEMPTS;
+        };
+
+#ifdef _WIN32
+        struct ChangeNotifications
+        {
+            HANDLE directory = INVALID_HANDLE_VALUE;
+            OVERLAPPED overlapped = {};
+            DWORD buffer[4096];
+        };
+
+        bool RequestChanges(ChangeNotifications& notifications)
+        {
+            return ReadDirectoryChangesW(notifications.directory, notifications.buffer, sizeof(notifications.buffer), TRUE,
+                FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME, nullptr, &notifications.overlapped, nullptr) != 0;
+        }
+
+        bool OpenChangeNotifications(ChangeNotifications& notifications, const AssetWatcher&)
+        {
+            notifications.directory = CreateFileA(RESOURCES_PATH.c_str(), FILE_LIST_DIRECTORY,
+                FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING,
+                FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+            if (notifications.directory == INVALID_HANDLE_VALUE)
+                return false;
+
+            notifications.overlapped.hEvent = CreateEventA(nullptr, TRUE, FALSE, nullptr);
+            return notifications.overlapped.hEvent && RequestChanges(notifications);
+        }
+
+        void CloseChangeNotifications(ChangeNotifications& notifications)
+        {
+            if (notifications.directory != INVALID_HANDLE_VALUE)
+            {
+                // The buffer must outlive the pending request, so wait until the cancellation lands
+                DWORD bytesCount = 0;
+                if (CancelIoEx(notifications.directory, &notifications.overlapped))
+                    GetOverlappedResult(notifications.directory, &notifications.overlapped, &bytesCount, TRUE);
+                CloseHandle(notifications.directory);
+            }
+            if (notifications.overlapped.hEvent)
+                CloseHandle(notifications.overlapped.hEvent);
+        }
+
+        void ReadChangedNames(ChangeNotifications& notifications, std::vector<std::string>& names)
+        {
+            if (WaitForSingleObject(notifications.overlapped.hEvent, CHANGES_WAIT_MILLISECONDS) != WAIT_OBJECT_0)
+                return;
+
+            DWORD bytesCount = 0;
+            if (GetOverlappedResult(notifications.directory, &notifications.overlapped, &bytesCount, FALSE) && bytesCount > 0)
+            {
+                const char* record = reinterpret_cast<const char*>(notifications.buffer);
+                while (true)
+                {
+                    const FILE_NOTIFY_INFORMATION* information = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(record);
+                    const int nameLength = static_cast<int>(information->FileNameLength / sizeof(WCHAR));
+                    std::string name(WideCharToMultiByte(CP_UTF8, 0, information->FileName, nameLength, nullptr, 0, nullptr, nullptr), '\0');
+                    WideCharToMultiByte(CP_UTF8, 0, information->FileName, nameLength, &name[0], static_cast<int>(name.size()), nullptr, nullptr);
+                    std::replace(name.begin(), name.end(), '\\', '/');
+
+                    if (information->Action != FILE_ACTION_REMOVED && information->Action != FILE_ACTION_RENAMED_OLD_NAME)
+                        names.push_back(name);
+
+                    if (information->NextEntryOffset == 0)
+                        break;
+                    record += information->NextEntryOffset;
+                }
+            }
+
+            ResetEvent(notifications.overlapped.hEvent);
+            RequestChanges(notifications);
+        }
+#elif defined(__linux__)
+        struct ChangeNotifications
+        {
+            int descriptor = -1;
+
+            // Watch descriptor to the name prefix of the files in its directory
+            std::unordered_map<int, std::string> directories;
+            alignas(inotify_event) char buffer[4096];
+        };
+
+        bool OpenChangeNotifications(ChangeNotifications& notifications, const AssetWatcher& watcher)
+        {
+            notifications.descriptor = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+            if (notifications.descriptor < 0)
+                return false;
+
+            for (const auto& watchedAsset : watcher.watchedAssets)
+            {
+                const std::string& path = watchedAsset.second.path;
+                const std::string directory = path.substr(0, path.find_last_of('/') + 1);
+                const int watch = inotify_add_watch(notifications.descriptor, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+                if (watch < 0)
+                    return false;
+
+                notifications.directories[watch] = GetArchivedAssetName(directory);
+            }
+
+            return true;
+        }
+
+        void CloseChangeNotifications(ChangeNotifications& notifications)
+        {
+            if (notifications.descriptor >= 0)
+                close(notifications.descriptor);
+        }
+
+        void ReadChangedNames(ChangeNotifications& notifications, std::vector<std::string>& names)
+        {
+            pollfd request = {notifications.descriptor, POLLIN, 0};
+            if (poll(&request, 1, CHANGES_WAIT_MILLISECONDS) <= 0)
+                return;
+
+            ssize_t bytesCount = 0;
+            while ((bytesCount = read(notifications.descriptor, notifications.buffer, sizeof(notifications.buffer))) > 0)
+            {
+                for (ssize_t offset = 0; offset < bytesCount;)
+                {
+                    const inotify_event* event = reinterpret_cast<const inotify_event*>(notifications.buffer + offset);
+                    if (event->len > 0)
+                        names.push_back(notifications.directories[event->wd] + event->name);
+
+                    offset += sizeof(inotify_event) + event->len;
+                }
+            }
+        }
+#endif
+
+        bool ReloadAsset(AssetWatcher& watcher, const WatchedAsset& asset)
+        {
+            std::shared_ptr<const void> resource;
+            switch (asset.kind)
+            {
+                case EAssetKind::Image:
+                    resource = ReloadResource(GetImageCache(), asset.path);
+                    break;
+                case EAssetKind::SoundBuffer:
+                    resource = ReloadResource(GetSoundBufferCache(), asset.path);
+                    break;
+                case EAssetKind::Font:
+                    resource = ReloadResource(GetFontCache(), asset.path);
+                    break;
+                default:
+                    break;
+            }
+
+            if (!resource)
+                return false;
+
+            std::lock_guard<std::mutex> lock(watcher.mutex);
+            std::vector<ReloadedAsset>& reloadedAssets = watcher.reloadedAssets[static_cast<int>(asset.kind)];
+            const auto reloadedAsset = std::find_if(reloadedAssets.begin(), reloadedAssets.end(), [&asset](const ReloadedAsset& reloaded)
+                {
+                    return reloaded.path == asset.path;
+                });
+
+            // A version nobody took yet is simply replaced
+            if (reloadedAsset != reloadedAssets.end())
+                reloadedAsset->resource = std::move(resource);
+            else
+                reloadedAssets.push_back({asset.path, std::move(resource)});
+
+            ++watcher.reloadsCount;
+            return true;
+        }
+
+#if defined(_WIN32) || defined(__linux__)
+        void RunAssetWatcher(AssetWatcher& watcher, std::unique_ptr<ChangeNotifications> notifications)
+        {
+            std::unordered_map<std::string, PendingReload> pendingReloads;
+            std::vector<std::string> changedNames;
+
+            while (!watcher.isStopRequested)
+            {
+                changedNames.clear();
+                ReadChangedNames(*notifications, changedNames);
+
+                for (const std::string& name : changedNames)
+                {
+                    if (watcher.watchedAssets.count(name))
+                        pendingReloads[name] = PendingReload();
+                }
+
+                for (auto pendingReload = pendingReloads.begin(); pendingReload != pendingReloads.end();)
+                {
+                    PendingReload& reload = pendingReload->second;
+                    if (reload.sinceChange.getElapsedTime().asSeconds() < RELOAD_SETTLE_SECONDS)
+                    {
+                        ++pendingReload;
+                        continue;
+                    }
+
+                    // A file that is still being written fails to decode, so it is retried a few times
+                    const WatchedAsset& asset = watcher.watchedAssets.at(pendingReload->first);
+                    if (ReloadAsset(watcher, asset))
+                    {
+                        std::cout << "Reloaded " << asset.path << std::endl;
+                    }
+                    else if (--reload.attemptsLeft > 0)
+                    {
+                        reload.sinceChange.restart();
+                        ++pendingReload;
+                        continue;
+                    }
+                    else
+                    {
+                        std::cerr << "Failed to reload " << asset.path << std::endl;
+                    }
+
+                    pendingReload = pendingReloads.erase(pendingReload);
+                }
+            }
+
+            CloseChangeNotifications(*notifications);
+        }
+#endif
+
+        void WatchAsset(AssetWatcher& watcher, const std::string& path, const EAssetKind kind)
+        {
+            WatchedAsset& asset = watcher.watchedAssets[GetArchivedAssetName(path)];
+            asset.path = path;
+            asset.kind = kind;
+        }
+    }
+
+    bool StartAssetWatcher(AssetWatcher& watcher)
+    {
+        for (const std::string& textureName : ATLAS_TEXTURE_NAMES)
+            WatchAsset(watcher, RESOURCES_PATH + textureName, EAssetKind::Image);
+
+        WatchAsset(watcher, RESOURCES_PATH + EAT_SOUND_NAME, EAssetKind::SoundBuffer);
+        WatchAsset(watcher, RESOURCES_PATH + DEATH_SOUND_NAME, EAssetKind::SoundBuffer);
+        WatchAsset(watcher, RESOURCES_PATH + FONT_NAME, EAssetKind::Font);
+
+#if defined(_WIN32) || defined(__linux__)
+        std::unique_ptr<ChangeNotifications> notifications(new ChangeNotifications());
+        if (!OpenChangeNotifications(*notifications, watcher))
+        {
+            CloseChangeNotifications(*notifications);
+            return false;
+        }
+
+        watcher.isStopRequested = false;
+        watcher.thread = std::thread(RunAssetWatcher, std::ref(watcher), std::move(notifications));
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    void StopAssetWatcher(AssetWatcher& watcher)
+    {
+        watcher.isStopRequested = true;
+        if (watcher.thread.joinable())
+            watcher.thread.join();
+    }
+
+    // The caller keeps the returned versions alive until it has acquired them, then they are freed with the last user
+    std::vector<ReloadedAsset> TakeReloadedAssets(AssetWatcher& watcher, const EAssetKind kind)
+    {
+        std::vector<ReloadedAsset> reloadedAssets;
+
+        std::lock_guard<std::mutex> lock(watcher.mutex);
+        std::swap(reloadedAssets, watcher.reloadedAssets[static_cast<int>(kind)]);
+        return reloadedAssets;
+    }
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace ApplesGame
+{
+    enum class EAssetKind
+    {
+        Image,
+        SoundBuffer,
+        Font,
+        None
+    };
+
+    struct WatchedAsset
+    {
+        std::string path;
+        EAssetKind kind = EAssetKind::None;
+    };
+
+    // A freshly loaded version, kept alive until its user has acquired it from the resource cache
+    struct ReloadedAsset
+    {
+        std::string path;
+        std::shared_ptr<const void> resource;
+    };
+
+    // Reloads edited files under RESOURCES_PATH on its own thread, users pick the new versions up from the resource caches
+    struct AssetWatcher
+    {
+        std::thread thread;
+        std::atomic<bool> isStopRequested{false};
+        std::atomic<int> reloadsCount{0};
+
+        // Keyed by the name relative to RESOURCES_PATH, the path is the one the caches know the asset by
+        std::unordered_map<std::string, WatchedAsset> watchedAssets;
+
+        // Taken by their users, after that the caches only keep weak references to them
+        std::mutex mutex;
+        std::vector<ReloadedAsset> reloadedAssets[static_cast<int>(EAssetKind::None)];
+    };
+
+    bool StartAssetWatcher(AssetWatcher& watcher);
+    void StopAssetWatcher(AssetWatcher& watcher);
+    std::vector<ReloadedAsset> TakeReloadedAssets(AssetWatcher& watcher, EAssetKind kind);
+}
@@ -1,18 +1,60 @@
 #pragma once
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace ApplesGame
 {
     const std::string RESOURCES_PATH = "Resources/";
+    const std::string ASSET_ARCHIVE_PATH = "Resources.pak";
+    const std::string DECODED_ASSET_CACHE_PATH = "AssetCache/";
     const std::string FONT_NAME = "/Fonts/Roboto-Black.ttf";
+    const std::string PLAYER_TEXTURE_NAME = "Player.png";
+    const std::string APPLE_TEXTURE_NAME = "Apple.png";
+    const std::string ROCK_TEXTURE_NAME = "Rock.png";
+    const std::vector<std::string> ATLAS_TEXTURE_NAMES = {PLAYER_TEXTURE_NAME, APPLE_TEXTURE_NAME, ROCK_TEXTURE_NAME};
+    constexpr float PLAYER_RADIUS = 10.0f;
+    constexpr float APPLE_RADIUS = 10.0f;
+    constexpr float ROCK_SIZE = 20.0f;
+
+    // Largest size in pixels each atlas image is drawn at, bigger sources are resampled down to it when packed
+    const std::unordered_map<std::string, unsigned> ATLAS_TEXTURE_SIZES = {
+        {PLAYER_TEXTURE_NAME, static_cast<unsigned>(PLAYER_RADIUS * 2.0f)},
+        {APPLE_TEXTURE_NAME, static_cast<unsigned>(APPLE_RADIUS * 2.0f)},
+        {ROCK_TEXTURE_NAME, static_cast<unsigned>(ROCK_SIZE)}
+    };
+    const std::string EAT_SOUND_NAME = "AppleEat.wav";
+    const std::string DEATH_SOUND_NAME = "Death.wav";
     const std::string GAME_TITLE = "Apples Game";
     constexpr int SCREEN_WIDTH = 1200;
     constexpr int SCREEN_HEIGHT = 800;
     constexpr int APPLES_AMOUNT_MIN = 30;
     constexpr int APPLES_AMOUNT_MAX = 50;
+
+    // Upper bound of the --apples override, meant for stress loads
+    constexpr int APPLES_AMOUNT_OVERRIDE_MAX = 100000;
+    // Denser fields rarely find a free spot for the next apple, so beyond this count apples may overlap
+    constexpr int NON_OVERLAPPING_APPLES_MAX = 1000;
     constexpr int ROCKS_AMOUNT_MIN = 25;
     constexpr int ROCKS_AMOUNT_MAX = 40;
     constexpr int RESTART_DELAY = 2;
     constexpr float INITIAL_ANGLE = 0.0f;
     constexpr float ROTATION_ANGLE = -90.0f;
+    constexpr float REACHABILITY_CELL_SIZE = 5.0f;
+    constexpr int LEVEL_GENERATION_ATTEMPTS = 32;
+    constexpr float SIMULATION_TICK_RATE = 60.0f;
+    constexpr int MAX_SIMULATION_STEPS_PER_FRAME = 5;
+    constexpr float RENDER_FRAME_RATE = 240.0f; // 0 - unlimited
+    constexpr bool IS_VSYNC_ENABLED = false;
+    constexpr int FRAME_PACER_SPIN_MICROSECONDS = 1500;
+    constexpr int PARTICLES_CAPACITY = 100000;
+    constexpr float PARTICLE_SIZE = 3.0f;
+    constexpr float PARTICLE_GRAVITY = 300.0f;
+    constexpr float DYNAMIC_RESOLUTION_TARGET_FRAME_RATE = 60.0f; // budget of the presented frames, not the render frame cap
+    constexpr float DYNAMIC_RESOLUTION_MIN_SCALE = 0.5f;
+    constexpr float DYNAMIC_RESOLUTION_MAX_SCALE = 1.0f;
+    constexpr int DYNAMIC_RESOLUTION_ADJUST_FRAMES = 30;
+    constexpr int LOADING_SCREEN_FRAME_MILLISECONDS = 16;
+    constexpr int ASSET_RELOAD_POLL_MILLISECONDS = 50;
+    constexpr float JOB_PARALLEL_COST_THRESHOLD = 50000.0f; // estimated nanoseconds, cheaper work stays on the calling thread
 }
@@ -0,0 +1,186 @@
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include "DecodedAssetCache.h"
+#include "Constants.h"
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+namespace ApplesGame
+{
+    namespace
+    {
+        constexpr uint32_t DECODED_ASSET_VERSION = 1;
+
+        enum class EDecodedAssetKind : uint32_t
+        {
+            Image,
+            SoundBuffer
+        };
+
+        // Image: first = width, second = height; sound buffer: first = channels count, second = sample rate
+        struct DecodedAssetHeader
+        {
+            uint64_t sourceHash = 0;
+            uint32_t version = DECODED_ASSET_VERSION;
+            EDecodedAssetKind kind = EDecodedAssetKind::Image;
+            uint32_t first = 0;
+            uint32_t second = 0;
+            uint64_t dataSize = 0;
+        };
+
+        // Named by the asset, so an edited source overwrites its old entry instead of adding another
+        std::string GetDecodedAssetPath(const std::string& assetName, const EDecodedAssetKind kind)
+        {
+            std::ostringstream path;
+            path << DECODED_ASSET_CACHE_PATH << std::hex << HashAssetSource(assetName.data(), assetName.size())
+                << (kind == EDecodedAssetKind::Image ? ".rgba" : ".pcm");
+            return path.str();
+        }
+
+        // Returns a pointer to the decoded data inside the mapping, or nullptr when the entry is missing or stale
+        const uint8_t* OpenDecodedAsset(MappedFile& file, DecodedAssetHeader& header, const std::string& assetName,
+                                        const uint64_t sourceHash, const EDecodedAssetKind kind)
+        {
+            if (!OpenMappedFile(file, GetDecodedAssetPath(assetName, kind)) || file.size < sizeof(header))
+                return nullptr;
+
+            std::memcpy(&header, file.data, sizeof(header));
+            if (header.sourceHash != sourceHash || header.version != DECODED_ASSET_VERSION || header.kind != kind ||
+                header.dataSize != file.size - sizeof(header))
+            {
+                return nullptr;
+            }
+
+            return file.data + sizeof(header);
+        }
+
+        // Written under a temporary name first so a concurrent reader never maps a half-written entry,
+        // the entry replaces the stale one of the same asset
+        void StoreDecodedAsset(const DecodedAssetHeader& header, const std::string& assetName, const void* data)
+        {
+#ifdef _WIN32
+            _mkdir(DECODED_ASSET_CACHE_PATH.c_str());
+#else
+            mkdir(DECODED_ASSET_CACHE_PATH.c_str(), 0755);
+#endif
+            const std::string path = GetDecodedAssetPath(assetName, header.kind);
+            std::ostringstream temporaryPath;
+            temporaryPath << path << "." << std::this_thread::get_id() << ".tmp";
+
+            {
+                std::ofstream file(temporaryPath.str(), std::ios::binary | std::ios::trunc);
+                file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+                file.write(static_cast<const char*>(data), static_cast<std::streamsize>(header.dataSize));
+                if (!file)
+                {
+                    file.close();
+                    std::remove(temporaryPath.str().c_str());
+                    return;
+                }
+            }
+
+            if (std::rename(temporaryPath.str().c_str(), path.c_str()) == 0)
+                return;
+
+            // Windows never renames over an existing file, so the stale entry goes first, unless a reader still maps it
+            std::remove(path.c_str());
+            if (std::rename(temporaryPath.str().c_str(), path.c_str()) != 0)
+                std::remove(temporaryPath.str().c_str());
+        }
+    }
+
+    bool LoadDecodedResource(sf::Image& image, const std::string& assetName, const void* source, const size_t sourceSize)
+    {
+        const uint64_t sourceHash = HashAssetSource(source, sourceSize);
+        MappedFile file;
+        DecodedAssetHeader header;
+
+        if (const uint8_t* pixels = OpenDecodedAsset(file, header, assetName, sourceHash, EDecodedAssetKind::Image))
+        {
+            if (header.dataSize == static_cast<uint64_t>(header.first) * header.second * 4)
+            {
+                image.create(header.first, header.second, pixels);
+                CloseMappedFile(file);
+                ++GetDecodedAssetCacheStats().hitsCount;
+                return true;
+            }
+        }
+        CloseMappedFile(file);
+
+        if (!image.loadFromMemory(source, sourceSize))
+            return false;
+
+        ++GetDecodedAssetCacheStats().missesCount;
+        header = DecodedAssetHeader();
+        header.sourceHash = sourceHash;
+        header.kind = EDecodedAssetKind::Image;
+        header.first = image.getSize().x;
+        header.second = image.getSize().y;
+        header.dataSize = static_cast<uint64_t>(header.first) * header.second * 4;
+        StoreDecodedAsset(header, assetName, image.getPixelsPtr());
+        return true;
+    }
+
+    bool LoadDecodedResource(sf::SoundBuffer& soundBuffer, const std::string& assetName, const void* source,
+                             const size_t sourceSize)
+    {
+        const uint64_t sourceHash = HashAssetSource(source, sourceSize);
+        MappedFile file;
+        DecodedAssetHeader header;
+
+        if (const uint8_t* samples = OpenDecodedAsset(file, header, assetName, sourceHash, EDecodedAssetKind::SoundBuffer))
+        {
+            if (header.first > 0 && header.dataSize % (sizeof(sf::Int16) * header.first) == 0 &&
+                soundBuffer.loadFromSamples(reinterpret_cast<const sf::Int16*>(samples), header.dataSize / sizeof(sf::Int16),
+                    header.first, header.second))
+            {
+                CloseMappedFile(file);
+                ++GetDecodedAssetCacheStats().hitsCount;
+                return true;
+            }
+        }
+        CloseMappedFile(file);
+
+        if (!soundBuffer.loadFromMemory(source, sourceSize))
+            return false;
+
+        ++GetDecodedAssetCacheStats().missesCount;
+        header = DecodedAssetHeader();
+        header.sourceHash = sourceHash;
+        header.kind = EDecodedAssetKind::SoundBuffer;
+        header.first = soundBuffer.getChannelCount();
+        header.second = soundBuffer.getSampleRate();
+        header.dataSize = soundBuffer.getSampleCount() * sizeof(sf::Int16);
+        StoreDecodedAsset(header, assetName, soundBuffer.getSamples());
+        return true;
+    }
+
+    // FNV-1a, hashing the encoded bytes costs a fraction of decoding them
+    uint64_t HashAssetSource(const void* source, const size_t sourceSize)
+    {
+        const uint8_t* bytes = static_cast<const uint8_t*>(source);
+        uint64_t hash = 14695981039346656037ull;
+
+        for (size_t i = 0; i < sourceSize; ++i)
+        {
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+        }
+
+        return hash;
+    }
+
+    DecodedAssetCacheStats& GetDecodedAssetCacheStats()
+    {
+        static DecodedAssetCacheStats stats;
+        return stats;
+    }
+}
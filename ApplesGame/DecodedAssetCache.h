@@ -0,0 +1,23 @@
+#pragma once
+#include <SFML/Audio/SoundBuffer.hpp>
+#include <SFML/Graphics/Image.hpp>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace ApplesGame
+{
+    struct DecodedAssetCacheStats
+    {
+        std::atomic<int> hitsCount{0};
+        std::atomic<int> missesCount{0};
+    };
+
+    // Pixels and samples decoded once are kept under DECODED_ASSET_CACHE_PATH, one entry per asset name holding the hash
+    // of its encoded source, so an edited source replaces its stale entry instead of leaving it behind
+    bool LoadDecodedResource(sf::Image& image, const std::string& assetName, const void* source, size_t sourceSize);
+    bool LoadDecodedResource(sf::SoundBuffer& soundBuffer, const std::string& assetName, const void* source, size_t sourceSize);
+    uint64_t HashAssetSource(const void* source, size_t sourceSize);
+    DecodedAssetCacheStats& GetDecodedAssetCacheStats();
+}
@@ -0,0 +1,94 @@
+#include <algorithm>
+#include <cmath>
+#include "DynamicResolution.h"
+
+namespace ApplesGame
+{
+    namespace
+    {
+        // Share of the frame budget the controller aims at, leaves room for spikes
+        constexpr float FRAME_BUDGET_USAGE = 0.9f;
+        constexpr float MIN_SCALE_CHANGE = 0.05f;
+        constexpr float FRAME_TIME_SMOOTHING = 0.1f;
+
+        void ApplyScale(DynamicResolution& resolution, const float scale)
+        {
+            resolution.scale = scale;
+            if (!resolution.isAvailable)
+                return;
+
+            resolution.view.setViewport({0.f, 0.f, scale, scale});
+
+            // Same pixel rounding SFML uses for the viewport, so the sprite samples exactly what was drawn
+            const sf::IntRect drawnRect = resolution.target.getViewport(resolution.view);
+            const sf::Vector2u size = resolution.target.getSize();
+            resolution.sprite.setTextureRect(drawnRect);
+            resolution.sprite.setScale(static_cast<float>(size.x) / static_cast<float>(drawnRect.width),
+                static_cast<float>(size.y) / static_cast<float>(drawnRect.height));
+        }
+    }
+
+    void InitializeDynamicResolution(DynamicResolution& resolution, const unsigned width, const unsigned height,
+                                     const float targetFrameRate)
+    {
+        resolution.targetFrameTime = targetFrameRate > 0.f ? 1.f / targetFrameRate : 0.f;
+        resolution.averageFrameTime = 0.f;
+        resolution.framesSinceAdjustment = 0;
+        resolution.isAvailable = resolution.target.create(width, height);
+
+        // Without the off-screen target there is nothing to scale
+        if (!resolution.isAvailable)
+        {
+            resolution.targetFrameTime = 0.f;
+            return;
+        }
+
+        resolution.target.setSmooth(true);
+        resolution.view.reset({0.f, 0.f, static_cast<float>(width), static_cast<float>(height)});
+        resolution.sprite.setTexture(resolution.target.getTexture());
+        ApplyScale(resolution, DYNAMIC_RESOLUTION_MAX_SCALE);
+    }
+
+    sf::RenderTarget& BeginDynamicResolutionFrame(DynamicResolution& resolution, sf::RenderWindow& window)
+    {
+        if (!resolution.isAvailable)
+            return window;
+
+        resolution.target.setView(resolution.view);
+        resolution.target.clear();
+        return resolution.target;
+    }
+
+    void PresentDynamicResolutionFrame(DynamicResolution& resolution, sf::RenderWindow& window)
+    {
+        if (!resolution.isAvailable)
+            return;
+
+        resolution.target.display();
+        window.draw(resolution.sprite);
+    }
+
+    // frameTime is the time spent producing the frame, without waiting for the swap, which vsync stretches to the refresh interval
+    void UpdateDynamicResolution(DynamicResolution& resolution, const float frameTime)
+    {
+        if (resolution.targetFrameTime <= 0.f)
+            return;
+
+        resolution.averageFrameTime += (frameTime - resolution.averageFrameTime) * FRAME_TIME_SMOOTHING;
+
+        if (++resolution.framesSinceAdjustment < DYNAMIC_RESOLUTION_ADJUST_FRAMES)
+            return;
+
+        // Frame time follows the pixel count, which grows with the square of the scale
+        const float budget = resolution.targetFrameTime * FRAME_BUDGET_USAGE;
+        const float desiredScale = std::min(DYNAMIC_RESOLUTION_MAX_SCALE, std::max(DYNAMIC_RESOLUTION_MIN_SCALE,
+            resolution.scale * std::sqrt(budget / std::max(resolution.averageFrameTime, 0.0001f))));
+
+        if (std::abs(desiredScale - resolution.scale) >= MIN_SCALE_CHANGE ||
+            (desiredScale != resolution.scale && (desiredScale == DYNAMIC_RESOLUTION_MIN_SCALE || desiredScale == DYNAMIC_RESOLUTION_MAX_SCALE)))
+        {
+            ApplyScale(resolution, desiredScale);
+            resolution.framesSinceAdjustment = 0;
+        }
+    }
+}
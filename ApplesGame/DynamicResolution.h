@@ -0,0 +1,25 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include "Constants.h"
+
+namespace ApplesGame
+{
+    // The world is drawn into the top-left part of an off-screen target and stretched over the window,
+    // the part shrinks while frames take longer than the target frame time
+    struct DynamicResolution
+    {
+        sf::RenderTexture target;
+        sf::View view;
+        sf::Sprite sprite;
+        bool isAvailable = false;
+        float scale = DYNAMIC_RESOLUTION_MAX_SCALE;
+        float targetFrameTime = 0.f;
+        float averageFrameTime = 0.f;
+        int framesSinceAdjustment = 0;
+    };
+
+    void InitializeDynamicResolution(DynamicResolution& resolution, unsigned width, unsigned height, float targetFrameRate);
+    sf::RenderTarget& BeginDynamicResolutionFrame(DynamicResolution& resolution, sf::RenderWindow& window);
+    void PresentDynamicResolutionFrame(DynamicResolution& resolution, sf::RenderWindow& window);
+    void UpdateDynamicResolution(DynamicResolution& resolution, float frameTime);
+}
@@ -0,0 +1,52 @@
+#include <thread>
+#include <SFML/System/Sleep.hpp>
+#include "FramePacer.h"
+#include "Constants.h"
+
+namespace ApplesGame
+{
+    void InitializeFramePacer(FramePacer& pacer, const float frameRateLimit)
+    {
+        pacer.frameDuration = frameRateLimit > 0.f ? sf::seconds(1.f / frameRateLimit) : sf::Time::Zero;
+        pacer.framesCount = 0;
+        pacer.missedDeadlinesCount = 0;
+        RestartFramePacer(pacer);
+    }
+
+    void RestartFramePacer(FramePacer& pacer)
+    {
+        pacer.clock.restart();
+        pacer.nextFrameTime = pacer.frameDuration;
+    }
+
+    void WaitForNextFrame(FramePacer& pacer)
+    {
+        ++pacer.framesCount;
+
+        if (pacer.frameDuration == sf::Time::Zero)
+            return;
+
+        const sf::Time spinTime = sf::microseconds(FRAME_PACER_SPIN_MICROSECONDS);
+        sf::Time now = pacer.clock.getElapsedTime();
+
+        if (now > pacer.nextFrameTime)
+        {
+            ++pacer.missedDeadlinesCount;
+
+            // Too late to catch up without a burst of frames, start a new schedule from now
+            if (now - pacer.nextFrameTime > pacer.frameDuration)
+                pacer.nextFrameTime = now;
+        }
+        else
+        {
+            // The OS sleep is only accurate to a scheduler tick, so wake up early and spin the rest
+            if (pacer.nextFrameTime - now > spinTime)
+                sf::sleep(pacer.nextFrameTime - now - spinTime);
+
+            while (pacer.clock.getElapsedTime() < pacer.nextFrameTime)
+                std::this_thread::yield();
+        }
+
+        pacer.nextFrameTime += pacer.frameDuration;
+    }
+}
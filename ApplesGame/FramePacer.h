@@ -0,0 +1,18 @@
+#pragma once
+#include <SFML/System/Clock.hpp>
+
+namespace ApplesGame
+{
+    struct FramePacer
+    {
+        sf::Clock clock;
+        sf::Time frameDuration;
+        sf::Time nextFrameTime;
+        int framesCount = 0;
+        int missedDeadlinesCount = 0;
+    };
+
+    void InitializeFramePacer(FramePacer& pacer, float frameRateLimit);
+    void RestartFramePacer(FramePacer& pacer);
+    void WaitForNextFrame(FramePacer& pacer);
+}
@@ -1,18 +1,27 @@
+#include <algorithm>
 #include <cassert>
 #include <random>
 #include "Game.h"
+#include "JobSystem.h"
 #include "Rock.h"
 #include "Player.h"
+#include "Reachability.h"
+#include "ResourceCache.h"
+#include "StartupProfile.h"
 
 namespace ApplesGame
 {
-	void LoadResources(Game& game)
+	// Estimated nanoseconds per object and query, whole levels are far below the job system threshold today
+	constexpr float COLLISION_QUERY_COST = 20.f;
+
+	bool LoadResources(Game& game)
 	{
-		assert(game.playerTexture.loadFromFile(RESOURCES_PATH + "Player.png"));
-		assert(game.appleTexture.loadFromFile(RESOURCES_PATH + "Apple.png"));
-		assert(game.rockTexture.loadFromFile(RESOURCES_PATH + "Rock.png"));
-		assert(game.eatSoundBuffer.loadFromFile(RESOURCES_PATH + "AppleEat.wav"));
-		assert(game.deathSoundBuffer.loadFromFile(RESOURCES_PATH + "Death.wav"));
+		game.eatSoundBuffer = AcquireResource(GetSoundBufferCache(), RESOURCES_PATH + EAT_SOUND_NAME);
+		game.deathSoundBuffer = AcquireResource(GetSoundBufferCache(), RESOURCES_PATH + DEATH_SOUND_NAME);
+		if (!game.sound)
+			game.sound = std::make_unique<sf::Sound>();
+
+		return game.eatSoundBuffer && game.deathSoundBuffer;
 	}
 
 	void InitializeScores(Game& game)
@@ -26,28 +35,48 @@ namespace ApplesGame
 		};
 	}
 
+	void EnsureLevelIsSolvable(Game& game)
+	{
+		// Reused by every attempt, so the grid buffers are allocated once per level
+		OccupancyGrid grid;
+
+		for (int attempt = 0; attempt < LEVEL_GENERATION_ATTEMPTS; ++attempt)
+		{
+			if (AreApplesReachable(grid, game.player, game.apples, game.rocks, SCREEN_WIDTH, SCREEN_HEIGHT))
+				return;
+
+			InitializeRocks(game.rocks, game);
+		}
+
+		// Every apple is reachable on an empty field, so drop the rocks rather than start an unwinnable level
+		if (!AreApplesReachable(grid, game.player, game.apples, game.rocks, SCREEN_WIDTH, SCREEN_HEIGHT))
+		{
+			game.rocksAmount = 0;
+			game.rocks.clear();
+		}
+	}
+
 	void InitializeGame(Game& game)
 	{
-		game.applesAmount = GetRandomInt(APPLES_AMOUNT_MIN, APPLES_AMOUNT_MAX);
+		game.applesAmount = game.applesAmountOverride > 0 ? std::min(game.applesAmountOverride, APPLES_AMOUNT_OVERRIDE_MAX) :
+			GetRandomInt(APPLES_AMOUNT_MIN, APPLES_AMOUNT_MAX);
 		game.rocksAmount = GetRandomInt(ROCKS_AMOUNT_MIN, ROCKS_AMOUNT_MAX);
 		game.gameState = EGameState::MainMenu;
+		++game.levelIndex;
 
-		InitializePlayer(game.player, game);
+		InitializePlayer(game.player);
 		InitializeApples(game.apples, game);
 		InitializeRocks(game.rocks, game);
+		if (game.mode & FINITE_MODE)
+			EnsureLevelIsSolvable(game);
+
 		if (game.scores.empty())
+		{
 			InitializeScores(game);
+			UpdateScoreboardMessage(game);
+		}
 
 		game.eatenApplesCount = 0;
-		game.scoreLabel.position = { 10, 10 };
-		game.scoreLabel.message = "Score: " + std::to_string(game.eatenApplesCount);
-		InitializeLabel(game.scoreLabel);
-
-		game.hintLabel.position = { 10, 30 };
-		game.hintLabel.message = "Use arrows to move pacman.\nEat apples, dont touch borders and rocks."
-			"\nFor toggle sound press \"M\" key"
-			"\nFor toggle hint message visibility press \"H\" key";
-		InitializeLabel(game.hintLabel);
 	}
 
 	void Restart(Game& game)
@@ -56,33 +85,10 @@ namespace ApplesGame
 
 		game.pauseTimeLeft = RESTART_DELAY;
 		game.isScoreUpdated = false;
+		game.isRedrawRequired = true;
 		game.gameState = EGameState::MainMenu;
 	}
 
-	void DrawGame(sf::RenderWindow& window, Game& game)
-	{
-		window.clear();
-		DrawPlayer(game.player, window);
-
-		for (Apple& apple : game.apples)
-		{
-			if (apple.isEaten == false)
-				DrawApple(apple, window);
-		}
-
-		for (Rock& rock : game.rocks)
-		{
-			DrawRock(rock, window);
-		}
-
-		window.draw(game.scoreLabel.text);
-
-		if (game.hintLabel.isVisible)
-			window.draw(game.hintLabel.text);
-
-		window.display();
-	}
-
 	void InitializeShape(const Vector2D& object, const float size, const sf::Color& color, sf::Shape& shape)
 	{
 		shape.setFillColor(color);
@@ -90,26 +96,26 @@ namespace ApplesGame
 		shape.setPosition(object.x, object.y);
 	}
 
-	void PlaySound(Game& game, const sf::SoundBuffer& soundToPlay)
+	void PlaySound(Game& game, const std::shared_ptr<const sf::SoundBuffer>& soundToPlay)
 	{
-		game.sound.setBuffer(soundToPlay);
-		game.sound.play();
+		if (!game.sound || !soundToPlay)
+			return;
+
+		game.sound->setBuffer(*soundToPlay);
+		game.sound->play();
 	}
 
-	void OnAppleCollisionEnter(Game& game, Apple& apple)
+	void OnAppleCollisionEnter(Game& game, const int appleIndex)
 	{
+		Apple& apple = game.apples[appleIndex];
+		game.particleBursts.push_back({apple.position, EParticleEffect::AppleEaten});
+
 		if (game.mode & ENDLESS_MODE)
-		{
 			SetRandomColliderPosition(apple.position, SCREEN_WIDTH, SCREEN_HEIGHT);
-			apple.sprite.setPosition(apple.position.x, apple.position.y);
-		}
 		else
-		{
 			apple.isEaten = true;
-		}
 
 		++game.eatenApplesCount;
-		game.scoreLabel.text.setString("Score: " + std::to_string(game.eatenApplesCount));
 
 		if (game.mode & ACCELERATION_MODE)
 			game.player.speed += game.player.ACCELERATION;
@@ -118,7 +124,7 @@ namespace ApplesGame
 			PlaySound(game, game.eatSoundBuffer);
 	}
 
-	bool CheckPlayerCollisions(sf::RenderWindow& window, Game& game)
+	bool CheckPlayerCollisions(Game& game)
 	{
 		// Check bounds
 		if (CheckCircleBoundsCollision(game.player))
@@ -126,17 +132,30 @@ namespace ApplesGame
 			if (!game.isMuted)
 				PlaySound(game, game.deathSoundBuffer);
 
+			game.particleBursts.push_back({game.player.position, EParticleEffect::PlayerDeath});
 			return true;
 		}
 
+		// Queries only read the level, so each one is split across the workers and the hits are applied in order afterwards
+		game.appleHits.assign(game.applesAmount, 0);
+		game.rockHits.assign(game.rocksAmount, 0);
+
+		ParallelFor(GetJobSystem(), game.applesAmount, COLLISION_QUERY_COST, [&game](const size_t begin, const size_t end)
+			{
+				for (size_t i = begin; i < end; ++i)
+					game.appleHits[i] = !game.apples[i].isEaten && CheckCircleCollision(game.player, game.apples[i]);
+			});
+		ParallelFor(GetJobSystem(), game.rocksAmount, COLLISION_QUERY_COST, [&game](const size_t begin, const size_t end)
+			{
+				for (size_t i = begin; i < end; ++i)
+					game.rockHits[i] = CheckCircleAndRectangleCollision(game.player, game.rocks[i]);
+			});
+
 		for (int i = 0; i < game.applesAmount; ++i)
 		{
-			if (game.apples[i].isEaten)
-				continue;
-
-			if (CheckCircleCollision(game.player, game.apples[i]))
+			if (game.appleHits[i])
 			{
-				OnAppleCollisionEnter(game, game.apples[i]);
+				OnAppleCollisionEnter(game, i);
 
 				if (game.eatenApplesCount == game.applesAmount && (game.mode & FINITE_MODE))
 					return true;
@@ -145,11 +164,12 @@ namespace ApplesGame
 
 		for (int i = 0; i < game.rocksAmount; ++i)
 		{
-			if (CheckCircleAndRectangleCollision(game.player, game.rocks[i]))
+			if (game.rockHits[i])
 			{
 				if (!game.isMuted)
 					PlaySound(game, game.deathSoundBuffer);
 
+				game.particleBursts.push_back({game.player.position, EParticleEffect::PlayerDeath});
 				return true;
 			}
 		}
@@ -157,36 +177,61 @@ namespace ApplesGame
 		return false;
 	}
 
-	void HandleMainMenuInput(const sf::Event& event, sf::RenderWindow& window, Game& game)
+	void HandleWindowEvent(const sf::Event& event, Game& game)
+	{
+		if (event.type == sf::Event::Closed)
+			game.isExitRequested = true;
+
+		// Stamped when read, not when the OS queued it, so the wait for the main loop to wake up
+		// before polling is not part of the reported input latency
+		const sf::Time eventTime = GetTimeSinceProcessStart();
+		RecordInputEvent(game.input, event, eventTime);
+
+		if (event.type == sf::Event::KeyPressed || event.type == sf::Event::Resized ||
+			event.type == sf::Event::GainedFocus)
+		{
+			game.isRedrawRequired = true;
+		}
+
+		if (game.gameState == EGameState::Playing)
+			HandlePlayingEvents(event, game);
+		else if (game.gameState == EGameState::MainMenu)
+			HandleMainMenuInput(event, game);
+		else if (game.gameState == EGameState::Scoreboard)
+			HandleScoreboardInput(event, game);
+
+		// Menus read their keys from the events directly, only the held keys carry over into the next game
+		if (game.gameState != EGameState::Playing)
+			TakeInputSnapshot(game.input, eventTime, game.tickInput);
+	}
+
+	bool IsStaticGameState(const Game& game)
+	{
+		return game.gameState == EGameState::MainMenu || game.gameState == EGameState::Scoreboard;
+	}
+
+	void HandleMainMenuInput(const sf::Event& event, Game& game)
 	{
 		if ((event.type == sf::Event::KeyPressed) && (event.key.code == sf::Keyboard::Num1))
 		{
-			game.menuLabels[static_cast<int>(EMenuOptions::FiniteMode)].text.setFillColor(sf::Color::Green);
-			game.menuLabels[static_cast<int>(EMenuOptions::EndlessMode)].text.setFillColor(sf::Color::Yellow);
 			game.mode |= FINITE_MODE;
 			game.mode &= ~ENDLESS_MODE;
 		}
 		
 		if ((event.type == sf::Event::KeyPressed) && (event.key.code == sf::Keyboard::Num2))
 		{
-			game.menuLabels[static_cast<int>(EMenuOptions::FiniteMode)].text.setFillColor(sf::Color::Yellow);
-			game.menuLabels[static_cast<int>(EMenuOptions::EndlessMode)].text.setFillColor(sf::Color::Green);
 			game.mode |= ENDLESS_MODE;
 			game.mode &= ~FINITE_MODE;
 		}
 		
 		if ((event.type == sf::Event::KeyPressed) && (event.key.code == sf::Keyboard::Num3))
 		{
-			game.menuLabels[static_cast<int>(EMenuOptions::AccelerationMode)].text.setFillColor(sf::Color::Green);
-			game.menuLabels[static_cast<int>(EMenuOptions::StandardSpeedMode)].text.setFillColor(sf::Color::Yellow);
 			game.mode |= ACCELERATION_MODE;
 			game.mode &= ~NO_ACCELERATION_MODE;
 		}
 		
 		if ((event.type == sf::Event::KeyPressed) && (event.key.code == sf::Keyboard::Num4))
 		{
-			game.menuLabels[static_cast<int>(EMenuOptions::AccelerationMode)].text.setFillColor(sf::Color::Yellow);
-			game.menuLabels[static_cast<int>(EMenuOptions::StandardSpeedMode)].text.setFillColor(sf::Color::Green);
 			game.mode |= NO_ACCELERATION_MODE;
 			game.mode &= ~ACCELERATION_MODE;
 		}
@@ -203,7 +248,7 @@ namespace ApplesGame
 		}
 	}
 
-	void HandleScoreboardInput(const sf::Event& event, sf::RenderWindow& window, Game& game)
+	void HandleScoreboardInput(const sf::Event& event, Game& game)
 	{
 		if ((event.type == sf::Event::KeyPressed) && (event.key.code == sf::Keyboard::Escape))
 		{
@@ -211,36 +256,33 @@ namespace ApplesGame
 		}
 	}
 
-	void UpdateEndGameState(sf::RenderWindow& window, Game& game, const float deltaTime)
+	void OnGameOver(Game& game)
 	{
-		game.pauseTimeLeft -= deltaTime;
-		std::string endMessage;
+		game.gameState = EGameState::EndGame;
 
 		if (game.applesAmount != game.eatenApplesCount)
 		{
-			endMessage = "You loose! The game will restart in " + std::to_string(RESTART_DELAY) + " seconds";
+			game.endGameMessage = "You loose! The game will restart in " + std::to_string(RESTART_DELAY) + " seconds";
 		}
 		else
 		{
-			endMessage = "You Win! The game will restart in " + std::to_string(RESTART_DELAY) + " seconds";
+			game.endGameMessage = "You Win! The game will restart in " + std::to_string(RESTART_DELAY) + " seconds";
 		}
 
 		if (!game.isScoreUpdated)
 		{
 			game.scores["Player"] = std::max(game.scores["Player"], game.eatenApplesCount);
 			game.isScoreUpdated = true;
+			UpdateScoreboardMessage(game);
 		}
-		
-		DisplayMessage(game, endMessage, window);
-
-		if (game.pauseTimeLeft <= 0.0f)
-			Restart(game);
 	}
 
-	void UpdateMainMenuGameState(sf::RenderWindow& window, Game& game)
+	void UpdateEndGameState(Game& game, const float deltaTime)
 	{
-		ShowMenu(game, window);
-		window.display();
+		game.pauseTimeLeft -= deltaTime;
+
+		if (game.pauseTimeLeft <= 0.0f)
+			Restart(game);
 	}
 
 	std::string GetScoresString(std::unordered_map<std::string, int>& scores)
@@ -266,33 +308,49 @@ namespace ApplesGame
 	}
 
 
-	void UpdateScoreboardState(sf::RenderWindow& window, Game& game)
-	{		
-		std::string scoresString = GetScoresString(game.scores);
-		scoresString += "\n\nPress ESC to return to main menu.";
-		DisplayMessage(game, scoresString, window);
+	void UpdateScoreboardMessage(Game& game)
+	{
+		game.scoreboardMessage = GetScoresString(game.scores);
+		game.scoreboardMessage += "\n\nPress ESC to return to main menu.";
 	}
 
-	void UpdatePlayingGameState(sf::RenderWindow& window, Game& game, const float deltaTime)
+	void UpdatePlayingGameState(Game& game, const float deltaTime)
 	{
-		CalculatePlayerMovement(game.player, deltaTime);
-		RotatePlayer(game.player);
-		
-		if (CheckPlayerCollisions(window, game))
+		CalculatePlayerMovement(game.player, game.tickInput, deltaTime);
+
+		// Direction presses travel with the next snapshot, the render thread adds when they reached the screen
+		for (const InputEvent& event : game.tickInput.events)
 		{
-			game.gameState = EGameState::EndGame;
+			if (event.isPressed && GetKeyDirection(event.key) != MoveDirection::None)
+				game.inputLatencySamples.push_back({event.time, GetTimeSinceProcessStart()});
 		}
 
-		DrawGame(window, game);
+		if (CheckPlayerCollisions(game))
+			OnGameOver(game);
+	}
+
+	void UpdateGame(Game& game, const float deltaTime)
+	{
+		switch (game.gameState)
+		{
+			case EGameState::Playing:
+				UpdatePlayingGameState(game, deltaTime);
+				break;
+			case EGameState::EndGame:
+				UpdateEndGameState(game, deltaTime);
+				break;
+			default:
+				break;
+		}
 	}
 
-	void HandlePlayingEvents(const sf::Event& event, sf::RenderWindow& window, Game& game)
+	void HandlePlayingEvents(const sf::Event& event, Game& game)
 	{
 		if ((event.type == sf::Event::KeyPressed) && (event.key.code == sf::Keyboard::Escape))
-			window.close();
+			game.isExitRequested = true;
 
 		if ((event.type == sf::Event::KeyPressed) && (event.key.code == sf::Keyboard::H))
-			game.hintLabel.isVisible = !game.hintLabel.isVisible;
+			game.isHintVisible = !game.isHintVisible;
 
 		if ((event.type == sf::Event::KeyPressed) && (event.key.code == sf::Keyboard::M))
 			game.isMuted = !game.isMuted;	
@@ -2,13 +2,15 @@
 #include <SFML/Graphics.hpp>
 #include <SFML/Audio/Sound.hpp>
 #include <SFML/Audio/SoundBuffer.hpp>
+#include <memory>
 #include <vector>
 #include <unordered_map>
 #include "Player.h"
 #include "Apple.h"
 #include "Rock.h"
+#include "Input.h"
+#include "Particles.h"
 #include "Constants.h"
-#include "UI.h"
 
 namespace ApplesGame
 {
@@ -46,52 +48,64 @@ namespace ApplesGame
 		int applesAmount;
 		std::vector<Apple> apples;
 
+		// Fixed apple count of every level for reproducible measurements, 0 keeps the random amount
+		int applesAmountOverride = 0;
+
 		int rocksAmount;
 		std::vector<Rock> rocks;
+		int levelIndex = 0;
 
 		//std::vector<Score> scores;
 		std::unordered_map <std::string, int> scores;
+		std::string scoreboardMessage;
+		std::string endGameMessage;
 		bool isMuted = false;
 
 		float pauseTimeLeft = RESTART_DELAY;
 
 		int eatenApplesCount = 0;
 
-		sf::Clock clock;
-		Label menuLabels[static_cast<int>(EMenuOptions::None)];
+		// Per-object results of the collision queries, kept between ticks to avoid allocations
+		std::vector<uint8_t> appleHits;
+		std::vector<uint8_t> rockHits;
 
-		Label scoreLabel;
-		Label hintLabel;
+		// Key events waiting for their tick, and what the tick being simulated sees of them
+		InputState input;
+		InputSnapshot tickInput;
+		std::vector<InputLatencySample> inputLatencySamples;
 
-		//Textures
-		sf::Texture playerTexture;
-		sf::Texture appleTexture;
-		sf::Texture rockTexture;
+		sf::Clock clock;
+		bool isHintVisible = true;
+		std::vector<ParticleBurst> particleBursts;
 
-		//Audio
-		sf::SoundBuffer eatSoundBuffer;
-		sf::SoundBuffer deathSoundBuffer;
-		sf::Sound sound;
+		//Audio, created by LoadResources so a game without it never opens the audio device
+		std::shared_ptr<const sf::SoundBuffer> eatSoundBuffer;
+		std::shared_ptr<const sf::SoundBuffer> deathSoundBuffer;
+		std::unique_ptr<sf::Sound> sound;
 
 		EGameState gameState;
 		bool isScoreUpdated = false;
+		bool isRedrawRequired = true;
+		bool isExitRequested = false;
 		uint8_t mode = DEFAULT_MODE;
 	};
 
+	void EnsureLevelIsSolvable(Game& game);
 	void InitializeGame(Game& game);
 	void Restart(Game& game);
-	void DrawGame(sf::RenderWindow& window, Game& game);
-	bool CheckPlayerCollisions(sf::RenderWindow& window, Game& game);
+	bool CheckPlayerCollisions(Game& game);
 	void InitializeShape(const Vector2D& object, const float size, const sf::Color& color, sf::Shape& shape);
-	void PlaySound(Game& game, const sf::SoundBuffer& soundToPlay);
-	void HandleMainMenuInput(const sf::Event& event, sf::RenderWindow& window, Game& game);
-	void HandleScoreboardInput(const sf::Event& event, sf::RenderWindow& window, Game& game);
-	void UpdateEndGameState(sf::RenderWindow& window, Game& game, const float deltaTime);
-	void UpdateMainMenuGameState(sf::RenderWindow& window, Game& game);
-	void UpdatePlayingGameState(sf::RenderWindow& window, Game& game, const float deltaTime);
-	void HandlePlayingEvents(const sf::Event& event, sf::RenderWindow& window, Game& game);
-	void LoadResources(Game& game);
+	void PlaySound(Game& game, const std::shared_ptr<const sf::SoundBuffer>& soundToPlay);
+	void HandleWindowEvent(const sf::Event& event, Game& game);
+	bool IsStaticGameState(const Game& game);
+	void HandleMainMenuInput(const sf::Event& event, Game& game);
+	void HandleScoreboardInput(const sf::Event& event, Game& game);
+	void UpdateEndGameState(Game& game, const float deltaTime);
+	void UpdatePlayingGameState(Game& game, const float deltaTime);
+	void UpdateGame(Game& game, const float deltaTime);
+	void HandlePlayingEvents(const sf::Event& event, Game& game);
+	bool LoadResources(Game& game);
 	void InitializeScores(Game& game);
-	void UpdateScoreboardState(sf::RenderWindow& window,Game& game);
 	std::string GetScoresString(std::unordered_map<std::string, int>& scores);
+	void UpdateScoreboardMessage(Game& game);
 }
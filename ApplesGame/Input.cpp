@@ -0,0 +1,92 @@
+#include <algorithm>
+#include <string>
+#include "Input.h"
+
+namespace ApplesGame
+{
+    namespace
+    {
+        bool IsKnownKey(const sf::Keyboard::Key key)
+        {
+            return key >= 0 && key < sf::Keyboard::KeyCount;
+        }
+
+        void PushInputEvent(InputState& state, const sf::Keyboard::Key key, const bool isPressed, const sf::Time time)
+        {
+            state.isKeyDown[key] = isPressed;
+            state.pendingEvents.push_back({key, isPressed, time});
+        }
+
+        // Sorts the samples in place, meant for the report at exit
+        void PrintLatencyPercentiles(std::vector<sf::Int64>& samples, const std::string& name, std::ostream& stream)
+        {
+            stream << name << ": ";
+            if (samples.empty())
+            {
+                stream << "no samples" << std::endl;
+                return;
+            }
+
+            std::sort(samples.begin(), samples.end());
+            const auto percentile = [&samples](const size_t percent)
+                {
+                    return samples[std::min(samples.size() - 1, samples.size() * percent / 100)] / 1000.f;
+                };
+
+            stream << "p50 " << percentile(50) << " ms, p90 " << percentile(90) << " ms, p99 " << percentile(99)
+                << " ms, max " << samples.back() / 1000.f << " ms (" << samples.size() << " samples)" << std::endl;
+        }
+    }
+
+    // Auto-repeated presses of a held key are dropped, only real changes reach the simulation
+    void RecordInputEvent(InputState& state, const sf::Event& event, const sf::Time time)
+    {
+        if ((event.type == sf::Event::KeyPressed || event.type == sf::Event::KeyReleased) && IsKnownKey(event.key.code))
+        {
+            const bool isPressed = event.type == sf::Event::KeyPressed;
+            if (state.isKeyDown[event.key.code] != isPressed)
+                PushInputEvent(state, event.key.code, isPressed, time);
+        }
+        else if (event.type == sf::Event::LostFocus)
+        {
+            // Releases never arrive once the window is in the background
+            for (int key = 0; key < sf::Keyboard::KeyCount; ++key)
+            {
+                if (state.isKeyDown[key])
+                    PushInputEvent(state, static_cast<sf::Keyboard::Key>(key), false, time);
+            }
+        }
+    }
+
+    void TakeInputSnapshot(InputState& state, const sf::Time endTime, InputSnapshot& snapshot)
+    {
+        snapshot.time = endTime;
+        snapshot.events.clear();
+
+        size_t takenCount = 0;
+        while (takenCount < state.pendingEvents.size() && state.pendingEvents[takenCount].time <= endTime)
+        {
+            const InputEvent& event = state.pendingEvents[takenCount++];
+            snapshot.isKeyDown[event.key] = event.isPressed;
+            snapshot.events.push_back(event);
+        }
+
+        state.pendingEvents.erase(state.pendingEvents.begin(), state.pendingEvents.begin() + takenCount);
+    }
+
+    bool IsKeyDown(const InputSnapshot& snapshot, const sf::Keyboard::Key key)
+    {
+        return IsKnownKey(key) && snapshot.isKeyDown[key];
+    }
+
+    // Key times are taken when the main loop reads the event, so every figure is a lower bound: a press can
+    // wait in the OS queue for up to one poll interval before that, and the interval is printed alongside
+    void PrintInputLatency(InputLatencyStats& stats, const sf::Time pollInterval, std::ostream& stream)
+    {
+        stream << "Input latency excludes the OS queue wait before events are read, up to "
+            << pollInterval.asSeconds() * 1000.f << " ms, so these are lower bounds" << std::endl;
+        PrintLatencyPercentiles(stats.eventToTickMicroseconds, "Input latency, key to tick", stream);
+        PrintLatencyPercentiles(stats.tickToDisplayMicroseconds, "Input latency, tick to display", stream);
+        PrintLatencyPercentiles(stats.eventToDisplayMicroseconds, "Input latency, key to display", stream);
+    }
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include <SFML/Window/Event.hpp>
+#include <SFML/System/Time.hpp>
+#include <array>
+#include <ostream>
+#include <vector>
+
+namespace ApplesGame
+{
+    struct InputEvent
+    {
+        sf::Keyboard::Key key = sf::Keyboard::Unknown;
+        bool isPressed = false;
+        sf::Time time;
+    };
+
+    // Key changes read from window events, waiting for the simulation tick that covers their time
+    struct InputState
+    {
+        std::vector<InputEvent> pendingEvents;
+        std::array<bool, sf::Keyboard::KeyCount> isKeyDown{};
+    };
+
+    // What one simulation tick sees: the key changes inside it in the order they happened, and the keys held at its end
+    struct InputSnapshot
+    {
+        sf::Time time;
+        std::vector<InputEvent> events;
+        std::array<bool, sf::Keyboard::KeyCount> isKeyDown{};
+    };
+
+    // A direction press and the simulation tick that turned the player with it
+    struct InputLatencySample
+    {
+        sf::Time eventTime;
+        sf::Time tickTime;
+    };
+
+    // Microseconds from the key event to the tick that consumed it and to the first displayed frame showing the result
+    struct InputLatencyStats
+    {
+        std::vector<sf::Int64> eventToTickMicroseconds;
+        std::vector<sf::Int64> tickToDisplayMicroseconds;
+        std::vector<sf::Int64> eventToDisplayMicroseconds;
+    };
+
+    void RecordInputEvent(InputState& state, const sf::Event& event, sf::Time time);
+    void TakeInputSnapshot(InputState& state, sf::Time endTime, InputSnapshot& snapshot);
+    bool IsKeyDown(const InputSnapshot& snapshot, sf::Keyboard::Key key);
+    void PrintInputLatency(InputLatencyStats& stats, sf::Time pollInterval, std::ostream& stream);
+}
@@ -0,0 +1,260 @@
+#include <algorithm>
+#include "JobSystem.h"
+#include "Constants.h"
+
+namespace ApplesGame
+{
+    namespace
+    {
+        // Each chunk of a parallel loop is worth at least this much work, in estimated nanoseconds
+        constexpr float MIN_CHUNK_COST = JOB_PARALLEL_COST_THRESHOLD / 4.f;
+        constexpr size_t CHUNKS_PER_THREAD = 4;
+
+        // Index of the queue owned by the current thread, threads outside the system own none
+        thread_local int ownQueueIndex = -1;
+
+        bool PopJob(JobSystem& system, Job& job)
+        {
+            const size_t queuesCount = system.queues.size();
+            if (queuesCount == 0 || system.queuedJobsCount == 0)
+                return false;
+
+            if (ownQueueIndex >= 0)
+            {
+                JobQueue& queue = *system.queues[ownQueueIndex];
+                std::lock_guard<std::mutex> lock(queue.mutex);
+                if (!queue.jobs.empty())
+                {
+                    job = std::move(queue.jobs.back());
+                    queue.jobs.pop_back();
+                    --system.queuedJobsCount;
+                    return true;
+                }
+            }
+
+            const size_t firstVictim = ownQueueIndex >= 0 ? ownQueueIndex + 1 : system.nextQueueIndex.load();
+            for (size_t i = 0; i < queuesCount; ++i)
+            {
+                JobQueue& queue = *system.queues[(firstVictim + i) % queuesCount];
+                std::lock_guard<std::mutex> lock(queue.mutex);
+                if (!queue.jobs.empty())
+                {
+                    job = std::move(queue.jobs.front());
+                    queue.jobs.pop_front();
+                    --system.queuedJobsCount;
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        void RunJob(Job& job)
+        {
+            job.function();
+            --job.counter->pendingJobsCount;
+        }
+
+        void RunWorker(JobSystem& system, const int queueIndex)
+        {
+            ownQueueIndex = queueIndex;
+
+            Job job;
+            while (!system.isStopRequested)
+            {
+                if (PopJob(system, job))
+                {
+                    RunJob(job);
+                    continue;
+                }
+
+                std::unique_lock<std::mutex> lock(system.sleepMutex);
+                system.wakeCondition.wait(lock, [&system]()
+                    {
+                        return system.isStopRequested || system.queuedJobsCount > 0;
+                    });
+            }
+        }
+
+        void RunTaskNode(JobSystem& system, TaskGraph& graph, std::atomic<int>* remainingDependencies, JobCounter& counter,
+                         const size_t index)
+        {
+            graph.nodes[index].function();
+
+            for (const size_t dependent : graph.nodes[index].dependents)
+            {
+                if (--remainingDependencies[dependent] == 0)
+                {
+                    ScheduleJob(system, counter, [&system, &graph, remainingDependencies, &counter, dependent]()
+                        {
+                            RunTaskNode(system, graph, remainingDependencies, counter, dependent);
+                        });
+                }
+            }
+        }
+    }
+
+    JobSystem::~JobSystem()
+    {
+        StopJobSystem(*this);
+    }
+
+    void StartJobSystem(JobSystem& system, const unsigned workersCount)
+    {
+        system.isStopRequested = false;
+        for (unsigned i = 0; i < workersCount; ++i)
+            system.queues.push_back(std::unique_ptr<JobQueue>(new JobQueue()));
+
+        for (unsigned i = 0; i < workersCount; ++i)
+            system.workers.emplace_back(RunWorker, std::ref(system), static_cast<int>(i));
+    }
+
+    void StopJobSystem(JobSystem& system)
+    {
+        {
+            std::lock_guard<std::mutex> lock(system.sleepMutex);
+            system.isStopRequested = true;
+        }
+        system.wakeCondition.notify_all();
+
+        for (std::thread& worker : system.workers)
+            worker.join();
+
+        system.workers.clear();
+        system.queues.clear();
+    }
+
+    void ScheduleJob(JobSystem& system, JobCounter& counter, std::function<void()> function)
+    {
+        ++counter.pendingJobsCount;
+        Job job = {std::move(function), &counter};
+
+        if (system.queues.empty())
+        {
+            RunJob(job);
+            return;
+        }
+
+        // Workers keep their own jobs close, other threads spread theirs over the workers
+        const size_t queueIndex = ownQueueIndex >= 0 ? ownQueueIndex : system.nextQueueIndex++ % system.queues.size();
+        {
+            JobQueue& queue = *system.queues[queueIndex];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.jobs.push_back(std::move(job));
+            ++system.queuedJobsCount;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(system.sleepMutex);
+        }
+        system.wakeCondition.notify_one();
+    }
+
+    // The waiting thread runs queued jobs itself, so nested waits never deadlock
+    void WaitForJobs(JobSystem& system, JobCounter& counter)
+    {
+        Job job;
+        while (counter.pendingJobsCount > 0)
+        {
+            if (PopJob(system, job))
+                RunJob(job);
+            else
+                std::this_thread::yield();
+        }
+    }
+
+    // itemCost is the estimated nanoseconds per item, cheap loops run on the calling thread without any scheduling
+    void ParallelFor(JobSystem& system, const size_t count, const float itemCost, const std::function<void(size_t, size_t)>& function)
+    {
+        const float totalCost = itemCost * static_cast<float>(count);
+        if (count == 0)
+            return;
+
+        if (system.workers.empty() || totalCost < JOB_PARALLEL_COST_THRESHOLD)
+        {
+            function(0, count);
+            return;
+        }
+
+        const size_t maxChunksCount = (system.workers.size() + 1) * CHUNKS_PER_THREAD;
+        const size_t chunksCount = std::min({count, maxChunksCount, static_cast<size_t>(totalCost / MIN_CHUNK_COST)});
+        const size_t chunkSize = (count + chunksCount - 1) / chunksCount;
+
+        JobCounter counter;
+        for (size_t begin = chunkSize; begin < count; begin += chunkSize)
+        {
+            const size_t end = std::min(begin + chunkSize, count);
+            ScheduleJob(system, counter, [&function, begin, end]()
+                {
+                    function(begin, end);
+                });
+        }
+
+        function(0, std::min(chunkSize, count));
+        WaitForJobs(system, counter);
+    }
+
+    size_t AddTask(TaskGraph& graph, const float cost, std::function<void()> function, const std::vector<size_t>& dependencies)
+    {
+        const size_t index = graph.nodes.size();
+        graph.nodes.push_back(TaskGraphNode());
+
+        TaskGraphNode& node = graph.nodes.back();
+        node.function = std::move(function);
+        node.cost = cost;
+        node.dependenciesCount = static_cast<int>(dependencies.size());
+
+        for (const size_t dependency : dependencies)
+            graph.nodes[dependency].dependents.push_back(index);
+
+        return index;
+    }
+
+    // Dependencies always point backwards, so running the tasks in order is a valid schedule for small graphs
+    void RunTaskGraph(JobSystem& system, TaskGraph& graph)
+    {
+        float totalCost = 0.f;
+        for (const TaskGraphNode& node : graph.nodes)
+            totalCost += node.cost;
+
+        if (system.workers.empty() || totalCost < JOB_PARALLEL_COST_THRESHOLD)
+        {
+            for (TaskGraphNode& node : graph.nodes)
+                node.function();
+            return;
+        }
+
+        std::unique_ptr<std::atomic<int>[]> remainingDependencies(new std::atomic<int>[graph.nodes.size()]);
+        for (size_t i = 0; i < graph.nodes.size(); ++i)
+            remainingDependencies[i] = graph.nodes[i].dependenciesCount;
+
+        JobCounter counter;
+        for (size_t i = 0; i < graph.nodes.size(); ++i)
+        {
+            if (graph.nodes[i].dependenciesCount > 0)
+                continue;
+
+            std::atomic<int>* remaining = remainingDependencies.get();
+            ScheduleJob(system, counter, [&system, &graph, remaining, &counter, i]()
+                {
+                    RunTaskNode(system, graph, remaining, counter, i);
+                });
+        }
+
+        WaitForJobs(system, counter);
+    }
+
+    JobSystem& GetJobSystem()
+    {
+        static JobSystem system;
+        static const bool isStarted = [](JobSystem& startedSystem)
+            {
+                const unsigned hardwareThreadsCount = std::thread::hardware_concurrency();
+                StartJobSystem(startedSystem, hardwareThreadsCount > 1 ? hardwareThreadsCount - 1 : 0);
+                return true;
+            }(system);
+
+        (void)isStarted;
+        return system;
+    }
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ApplesGame
+{
+    // Jobs scheduled against a counter are finished once it drops back to zero
+    struct JobCounter
+    {
+        std::atomic<int> pendingJobsCount{0};
+    };
+
+    struct Job
+    {
+        std::function<void()> function;
+        JobCounter* counter = nullptr;
+    };
+
+    // The owning worker takes its newest job, thieves take the oldest one from the other end
+    struct JobQueue
+    {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+    };
+
+    struct JobSystem
+    {
+        std::vector<std::thread> workers;
+        std::vector<std::unique_ptr<JobQueue>> queues;
+        std::atomic<int> queuedJobsCount{0};
+        std::atomic<unsigned> nextQueueIndex{0};
+        std::atomic<bool> isStopRequested{false};
+
+        std::mutex sleepMutex;
+        std::condition_variable wakeCondition;
+
+        // Joins the workers, so the process-wide instance shuts down cleanly at exit
+        ~JobSystem();
+    };
+
+    // A task runs once every task it depends on has finished, dependencies are indices of earlier tasks
+    struct TaskGraphNode
+    {
+        std::function<void()> function;
+        float cost = 0.f;
+        std::vector<size_t> dependents;
+        int dependenciesCount = 0;
+    };
+
+    struct TaskGraph
+    {
+        std::vector<TaskGraphNode> nodes;
+    };
+
+    void StartJobSystem(JobSystem& system, unsigned workersCount);
+    void StopJobSystem(JobSystem& system);
+    void ScheduleJob(JobSystem& system, JobCounter& counter, std::function<void()> function);
+    void WaitForJobs(JobSystem& system, JobCounter& counter);
+    void ParallelFor(JobSystem& system, size_t count, float itemCost, const std::function<void(size_t, size_t)>& function);
+    size_t AddTask(TaskGraph& graph, float cost, std::function<void()> function, const std::vector<size_t>& dependencies = {});
+    void RunTaskGraph(JobSystem& system, TaskGraph& graph);
+    JobSystem& GetJobSystem();
+}
@@ -0,0 +1,93 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace ApplesGame
+{
+    namespace
+    {
+        bool MapFile(MappedFile& file, const std::string& path)
+        {
+#ifdef _WIN32
+            file.fileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, nullptr);
+            if (file.fileHandle == INVALID_HANDLE_VALUE)
+            {
+                file.fileHandle = nullptr;
+                return false;
+            }
+
+            LARGE_INTEGER fileSize;
+            if (!GetFileSizeEx(file.fileHandle, &fileSize) || fileSize.QuadPart == 0)
+                return false;
+
+            file.mappingHandle = CreateFileMappingA(file.fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (!file.mappingHandle)
+                return false;
+
+            file.data = static_cast<const uint8_t*>(MapViewOfFile(file.mappingHandle, FILE_MAP_READ, 0, 0, 0));
+            file.size = static_cast<size_t>(fileSize.QuadPart);
+#else
+            file.fileDescriptor = open(path.c_str(), O_RDONLY);
+            if (file.fileDescriptor < 0)
+                return false;
+
+            struct stat fileStatus;
+            if (fstat(file.fileDescriptor, &fileStatus) != 0 || fileStatus.st_size == 0)
+                return false;
+
+            void* mapping = mmap(nullptr, static_cast<size_t>(fileStatus.st_size), PROT_READ, MAP_PRIVATE, file.fileDescriptor, 0);
+            if (mapping == MAP_FAILED)
+                return false;
+
+            file.data = static_cast<const uint8_t*>(mapping);
+            file.size = static_cast<size_t>(fileStatus.st_size);
+#endif
+            return file.data != nullptr;
+        }
+    }
+
+    bool OpenMappedFile(MappedFile& file, const std::string& path)
+    {
+        CloseMappedFile(file);
+
+        if (MapFile(file, path))
+            return true;
+
+        CloseMappedFile(file);
+        return false;
+    }
+
+    void CloseMappedFile(MappedFile& file)
+    {
+#ifdef _WIN32
+        if (file.data)
+            UnmapViewOfFile(file.data);
+        if (file.mappingHandle)
+            CloseHandle(file.mappingHandle);
+        if (file.fileHandle)
+            CloseHandle(file.fileHandle);
+
+        file.mappingHandle = nullptr;
+        file.fileHandle = nullptr;
+#else
+        if (file.data)
+            munmap(const_cast<uint8_t*>(file.data), file.size);
+        if (file.fileDescriptor >= 0)
+            close(file.fileDescriptor);
+
+        file.fileDescriptor = -1;
+#endif
+        file.data = nullptr;
+        file.size = 0;
+    }
+}
@@ -0,0 +1,23 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace ApplesGame
+{
+    // Whole file mapped read-only into the address space
+    struct MappedFile
+    {
+        const uint8_t* data = nullptr;
+        size_t size = 0;
+#ifdef _WIN32
+        void* fileHandle = nullptr;
+        void* mappingHandle = nullptr;
+#else
+        int fileDescriptor = -1;
+#endif
+    };
+
+    bool OpenMappedFile(MappedFile& file, const std::string& path);
+    void CloseMappedFile(MappedFile& file);
+}
@@ -0,0 +1,181 @@
+#include <algorithm>
+#include <cmath>
+#include "Particles.h"
+#include "Constants.h"
+#include "JobSystem.h"
+
+namespace ApplesGame
+{
+    namespace
+    {
+        struct ParticleEffectSettings
+        {
+            int particlesCount;
+            float minSpeed;
+            float maxSpeed;
+            float minLifetime;
+            float maxLifetime;
+            sf::Color colors[2];
+        };
+
+        // Estimated nanoseconds per particle, large pools are split across the job system
+        constexpr float PARTICLE_UPDATE_COST = 1.f;
+        constexpr float PARTICLE_VERTICES_COST = 4.f;
+
+        const ParticleEffectSettings EFFECTS_SETTINGS[static_cast<int>(EParticleEffect::None)] =
+        {
+            {48, 40.f, 160.f, 0.3f, 0.7f, {sf::Color(220, 40, 40), sf::Color(90, 200, 60)}},
+            {600, 60.f, 400.f, 0.5f, 1.2f, {sf::Color(255, 255, 0), sf::Color(255, 140, 0)}}
+        };
+
+        // Own xorshift generator, std::rand is shared with the simulation thread
+        float GetRandomUnitFloat(ParticlePool& pool)
+        {
+            pool.randomState ^= pool.randomState << 13;
+            pool.randomState ^= pool.randomState >> 17;
+            pool.randomState ^= pool.randomState << 5;
+            return static_cast<float>(pool.randomState >> 8) / 16777216.f;
+        }
+
+        float GetRandomRange(ParticlePool& pool, const float minValue, const float maxValue)
+        {
+            return minValue + (maxValue - minValue) * GetRandomUnitFloat(pool);
+        }
+
+        void MoveParticle(ParticlePool& pool, const size_t from, const size_t to)
+        {
+            pool.positionsX[to] = pool.positionsX[from];
+            pool.positionsY[to] = pool.positionsY[from];
+            pool.velocitiesX[to] = pool.velocitiesX[from];
+            pool.velocitiesY[to] = pool.velocitiesY[from];
+            pool.ages[to] = pool.ages[from];
+            pool.inverseLifetimes[to] = pool.inverseLifetimes[from];
+            pool.colors[to] = pool.colors[from];
+        }
+    }
+
+    void InitializeParticlePool(ParticlePool& pool, const size_t capacity)
+    {
+        pool.capacity = capacity;
+        pool.liveCount = 0;
+        pool.positionsX.assign(capacity, 0.f);
+        pool.positionsY.assign(capacity, 0.f);
+        pool.velocitiesX.assign(capacity, 0.f);
+        pool.velocitiesY.assign(capacity, 0.f);
+        pool.ages.assign(capacity, 0.f);
+        pool.inverseLifetimes.assign(capacity, 0.f);
+        pool.colors.assign(capacity, sf::Color::Transparent);
+
+        pool.vertices.setPrimitiveType(sf::Quads);
+        pool.vertices.resize(capacity * 4);
+        pool.vertices.clear();
+    }
+
+    void EmitParticleBurst(ParticlePool& pool, const ParticleBurst& burst)
+    {
+        const ParticleEffectSettings& settings = EFFECTS_SETTINGS[static_cast<int>(burst.effect)];
+
+        // A full pool drops the rest of the burst rather than growing
+        const size_t count = std::min(static_cast<size_t>(settings.particlesCount), pool.capacity - pool.liveCount);
+
+        for (size_t i = pool.liveCount; i < pool.liveCount + count; ++i)
+        {
+            const float angle = GetRandomRange(pool, 0.f, 6.2831853f);
+            const float speed = GetRandomRange(pool, settings.minSpeed, settings.maxSpeed);
+
+            pool.positionsX[i] = burst.position.x;
+            pool.positionsY[i] = burst.position.y;
+            pool.velocitiesX[i] = std::cos(angle) * speed;
+            pool.velocitiesY[i] = std::sin(angle) * speed;
+            pool.ages[i] = 0.f;
+            pool.inverseLifetimes[i] = 1.f / GetRandomRange(pool, settings.minLifetime, settings.maxLifetime);
+            pool.colors[i] = settings.colors[i % 2];
+        }
+
+        pool.liveCount += count;
+    }
+
+    // Stress load, death bursts at random spots of the area top the pool up to count live particles
+    void KeepParticlesAlive(ParticlePool& pool, const size_t count, const sf::FloatRect& area)
+    {
+        while (pool.liveCount < std::min(count, pool.capacity))
+        {
+            const Position2D position = {GetRandomRange(pool, area.left, area.left + area.width),
+                GetRandomRange(pool, area.top, area.top + area.height)};
+            EmitParticleBurst(pool, {position, EParticleEffect::PlayerDeath});
+        }
+    }
+
+    void UpdateParticles(ParticlePool& pool, const float deltaTime)
+    {
+        const sf::Clock clock;
+        float* positionsX = pool.positionsX.data();
+        float* positionsY = pool.positionsY.data();
+        float* velocitiesX = pool.velocitiesX.data();
+        float* velocitiesY = pool.velocitiesY.data();
+        float* ages = pool.ages.data();
+        const size_t count = pool.liveCount;
+
+        // Branchless and over plain arrays, so the compiler vectorises each chunk
+        ParallelFor(GetJobSystem(), count, PARTICLE_UPDATE_COST, [=](const size_t begin, const size_t end)
+            {
+                for (size_t i = begin; i < end; ++i)
+                {
+                    positionsX[i] += velocitiesX[i] * deltaTime;
+                    positionsY[i] += velocitiesY[i] * deltaTime;
+                    velocitiesY[i] += PARTICLE_GRAVITY * deltaTime;
+                    ages[i] += deltaTime;
+                }
+            });
+
+        // The last live particle takes the place of a dead one, keeping the live range packed
+        for (size_t i = 0; i < pool.liveCount;)
+        {
+            if (GetParticleOpacity(pool, i) > 0.f)
+            {
+                ++i;
+                continue;
+            }
+
+            --pool.liveCount;
+            MoveParticle(pool, pool.liveCount, i);
+        }
+
+        pool.updatesTime += clock.getElapsedTime();
+        ++pool.updatesCount;
+    }
+
+    float GetParticleOpacity(const ParticlePool& pool, const size_t index)
+    {
+        return 1.f - pool.ages[index] * pool.inverseLifetimes[index];
+    }
+
+    void DrawParticles(ParticlePool& pool, RenderQueue& queue)
+    {
+        if (pool.liveCount == 0)
+            return;
+
+        // Shrinking within the reserved capacity never reallocates
+        pool.vertices.resize(pool.liveCount * 4);
+        const float halfSize = PARTICLE_SIZE / 2.f;
+
+        ParallelFor(GetJobSystem(), pool.liveCount, PARTICLE_VERTICES_COST, [&pool, halfSize](const size_t begin, const size_t end)
+            {
+                for (size_t i = begin; i < end; ++i)
+                {
+                    sf::Color color = pool.colors[i];
+                    color.a = static_cast<sf::Uint8>(255.f * GetParticleOpacity(pool, i));
+
+                    const float x = pool.positionsX[i];
+                    const float y = pool.positionsY[i];
+                    sf::Vertex* quad = &pool.vertices[i * 4];
+                    quad[0] = sf::Vertex({x - halfSize, y - halfSize}, color);
+                    quad[1] = sf::Vertex({x + halfSize, y - halfSize}, color);
+                    quad[2] = sf::Vertex({x + halfSize, y + halfSize}, color);
+                    quad[3] = sf::Vertex({x - halfSize, y + halfSize}, color);
+                }
+            });
+
+        PushDrawable(queue, ERenderLayer::Effects, pool.vertices, nullptr);
+    }
+}
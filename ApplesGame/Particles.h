@@ -0,0 +1,49 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <vector>
+#include "Math.h"
+#include "RenderQueue.h"
+
+namespace ApplesGame
+{
+    enum class EParticleEffect
+    {
+        AppleEaten,
+        PlayerDeath,
+        None
+    };
+
+    struct ParticleBurst
+    {
+        Position2D position;
+        EParticleEffect effect = EParticleEffect::None;
+    };
+
+    // Structure of arrays with a fixed capacity, live particles are packed at the front and never allocated one by one
+    struct ParticlePool
+    {
+        size_t capacity = 0;
+        size_t liveCount = 0;
+        std::vector<float> positionsX;
+        std::vector<float> positionsY;
+        std::vector<float> velocitiesX;
+        std::vector<float> velocitiesY;
+        std::vector<float> ages;
+        std::vector<float> inverseLifetimes;
+        std::vector<sf::Color> colors;
+        uint32_t randomState = 0x9E3779B9u;
+        sf::VertexArray vertices;
+
+        // Time spent in UpdateParticles, printed with the frame times
+        sf::Time updatesTime;
+        int updatesCount = 0;
+    };
+
+    void InitializeParticlePool(ParticlePool& pool, size_t capacity);
+    void EmitParticleBurst(ParticlePool& pool, const ParticleBurst& burst);
+    void KeepParticlesAlive(ParticlePool& pool, size_t count, const sf::FloatRect& area);
+    void UpdateParticles(ParticlePool& pool, float deltaTime);
+    float GetParticleOpacity(const ParticlePool& pool, size_t index);
+    void DrawParticles(ParticlePool& pool, RenderQueue& queue);
+}
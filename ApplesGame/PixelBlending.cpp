@@ -0,0 +1,73 @@
+#include "PixelBlending.h"
+
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#include <emmintrin.h>
+#define PIXEL_BLENDING_SSE2
+#endif
+
+namespace ApplesGame
+{
+    namespace
+    {
+        // x / 255 rounded to nearest, exact for every product of two 8-bit values
+        uint32_t DivideBy255(uint32_t x)
+        {
+            x += 128;
+            return (x + (x >> 8)) >> 8;
+        }
+
+#ifdef PIXEL_BLENDING_SSE2
+        // Same math as BlendPixel for two pixels widened to 16 bits per channel
+        __m128i BlendPixelPair(const __m128i source, const __m128i destination)
+        {
+            const __m128i alphaLanes = _mm_set_epi16(-1, 0, 0, 0, -1, 0, 0, 0);
+            const __m128i maxValue = _mm_set1_epi16(255);
+
+            const __m128i alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(source, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+            const __m128i sourceFactor = _mm_or_si128(_mm_andnot_si128(alphaLanes, alpha), _mm_and_si128(alphaLanes, maxValue));
+            const __m128i destinationFactor = _mm_sub_epi16(maxValue, alpha);
+
+            // Both products fit in 16 bits and so does their sum, since the factors add up to 255
+            __m128i sum = _mm_add_epi16(_mm_mullo_epi16(source, sourceFactor), _mm_mullo_epi16(destination, destinationFactor));
+            sum = _mm_add_epi16(sum, _mm_set1_epi16(128));
+            return _mm_srli_epi16(_mm_add_epi16(sum, _mm_srli_epi16(sum, 8)), 8);
+        }
+#endif
+    }
+
+    // sf::BlendAlpha: colour = src * srcAlpha + dst * (1 - srcAlpha), alpha = srcAlpha + dst * (1 - srcAlpha)
+    void BlendPixel(uint8_t* destination, const uint8_t* source)
+    {
+        const uint32_t alpha = source[3];
+        const uint32_t inverseAlpha = 255 - alpha;
+
+        for (int channel = 0; channel < 3; ++channel)
+            destination[channel] = static_cast<uint8_t>(DivideBy255(source[channel] * alpha + destination[channel] * inverseAlpha));
+
+        destination[3] = static_cast<uint8_t>(DivideBy255(alpha * 255 + destination[3] * inverseAlpha));
+    }
+
+    // Four pixels at a time with SSE2, the remainder one by one
+    void BlendPixelSpan(uint8_t* destination, const uint8_t* source, const size_t count)
+    {
+        size_t i = 0;
+
+#ifdef PIXEL_BLENDING_SSE2
+        const __m128i zero = _mm_setzero_si128();
+
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128i* destinationPixels = reinterpret_cast<__m128i*>(destination + i * 4);
+            const __m128i sourcePixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i * 4));
+            const __m128i oldPixels = _mm_loadu_si128(destinationPixels);
+
+            const __m128i low = BlendPixelPair(_mm_unpacklo_epi8(sourcePixels, zero), _mm_unpacklo_epi8(oldPixels, zero));
+            const __m128i high = BlendPixelPair(_mm_unpackhi_epi8(sourcePixels, zero), _mm_unpackhi_epi8(oldPixels, zero));
+            _mm_storeu_si128(destinationPixels, _mm_packus_epi16(low, high));
+        }
+#endif
+
+        for (; i < count; ++i)
+            BlendPixel(destination + i * 4, source + i * 4);
+    }
+}
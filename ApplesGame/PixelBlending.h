@@ -0,0 +1,10 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace ApplesGame
+{
+    // sf::BlendAlpha on 8-bit RGBA pixels with exact rounding, the scalar and SSE2 paths give identical results
+    void BlendPixel(uint8_t* destination, const uint8_t* source);
+    void BlendPixelSpan(uint8_t* destination, const uint8_t* source, size_t count);
+}
@@ -1,86 +1,141 @@
 #include "Player.h"
 #include "Constants.h"
-#include "Game.h"
 
 namespace ApplesGame
 {
-    void InitializePlayer(Player& player, const Game& game)
+    namespace
+    {
+        // Indexed by MoveDirection
+        const sf::Keyboard::Key DIRECTION_KEYS[] = {sf::Keyboard::Right, sf::Keyboard::Up, sf::Keyboard::Left, sf::Keyboard::Down};
+    }
+
+    void InitializePlayer(Player& player)
     {
         player.position.x = SCREEN_WIDTH / 2.0f;
         player.position.y = SCREEN_HEIGHT / 2.0f;
-        player.radius = 10.0f;
+        player.radius = PLAYER_RADIUS;
         player.speed = player.INITIAL_SPEED;
         player.direction = MoveDirection::None;
         player.name = "Player";
-
-        player.sprite.setTexture(game.playerTexture);
-        SetSpriteSize(player.sprite, player.radius * 2.f, player.radius * 2.f);
-        SetSpriteRelativeOrigin(player.sprite, 0.5f, 0.5f);
     }
 
-    void CalculatePlayerMovement(Player& player, const float deltaTime)
+    void InitializePlayerSprite(PlayerSprite& playerSprite, const sf::IntRect& textureRect, const float radius)
     {
-        //Player movement calculation
-        if (sf::Keyboard::isKeyPressed(sf::Keyboard::Right))
-            player.direction = MoveDirection::Right;
-        if (sf::Keyboard::isKeyPressed(sf::Keyboard::Up))
-            player.direction = MoveDirection::Up;
-        if (sf::Keyboard::isKeyPressed(sf::Keyboard::Left))
-            player.direction = MoveDirection::Left;
-        if (sf::Keyboard::isKeyPressed(sf::Keyboard::Down))
-            player.direction = MoveDirection::Down;
-
-        float deltaX = 0, deltaY = 0;
-
-        switch (player.direction)
+        playerSprite.sprite.setTextureRect(textureRect);
+        SetSpriteSize(playerSprite.sprite, radius * 2.f, radius * 2.f);
+        SetSpriteRelativeOrigin(playerSprite.sprite, 0.5f, 0.5f);
+
+        const sf::Vector2f scale = playerSprite.sprite.getScale();
+
+        for (int i = 0; i <= static_cast<int>(MoveDirection::None); ++i)
         {
-        case MoveDirection::Right:
+            PlayerSpriteTransform& transform = playerSprite.transforms[i];
+
+            if (static_cast<MoveDirection>(i) == MoveDirection::Left)
             {
-                deltaX = 1.f;
-                break;
+                transform.scale = {-scale.x, scale.y};
+                transform.rotation = INITIAL_ANGLE;
             }
-        case MoveDirection::Left:
+            else
             {
-                deltaX = -1.f;
-                break;
+                transform.scale = scale;
+                transform.rotation = static_cast<float>(i) * ROTATION_ANGLE;
             }
+        }
+
+        playerSprite.direction = MoveDirection::None;
+        playerSprite.sprite.setRotation(playerSprite.transforms[static_cast<int>(MoveDirection::None)].rotation);
+    }
+
+    MoveDirection GetKeyDirection(const sf::Keyboard::Key key)
+    {
+        for (int direction = 0; direction < static_cast<int>(MoveDirection::None); ++direction)
+        {
+            if (key == DIRECTION_KEYS[direction])
+                return static_cast<MoveDirection>(direction);
+        }
+
+        return MoveDirection::None;
+    }
+
+    Vector2D GetDirectionVector(const MoveDirection direction)
+    {
+        switch (direction)
+        {
+        case MoveDirection::Right:
+            return {1.f, 0.f};
+        case MoveDirection::Left:
+            return {-1.f, 0.f};
         case MoveDirection::Down:
+            return {0.f, 1.f};
+        case MoveDirection::Up:
+            return {0.f, -1.f};
+        default:
+            return {0.f, 0.f};
+        }
+    }
+
+    void CalculatePlayerMovement(Player& player, const InputSnapshot& input, const float deltaTime)
+    {
+        // Presses inside the tick turn the player in the order they happened, even ones already released again
+        bool isTurned = false;
+        for (const InputEvent& event : input.events)
+        {
+            const MoveDirection direction = GetKeyDirection(event.key);
+            if (event.isPressed && direction != MoveDirection::None)
             {
-                deltaY = 1.f;
-                break;
+                player.direction = direction;
+                isTurned = true;
             }
-        case MoveDirection::Up:
+        }
+
+        // Without a new press a released direction hands over to a key still held, Down first as before
+        if (!isTurned && (player.direction == MoveDirection::None ||
+            !IsKeyDown(input, DIRECTION_KEYS[static_cast<int>(player.direction)])))
+        {
+            for (int direction = static_cast<int>(MoveDirection::None) - 1; direction >= 0; --direction)
             {
-                deltaY = -1.f;
-                break;
+                if (IsKeyDown(input, DIRECTION_KEYS[direction]))
+                {
+                    player.direction = static_cast<MoveDirection>(direction);
+                    break;
+                }
             }
-        case MoveDirection::None:
-            deltaX = 0.0f;
-            deltaY = 0.0f;
-            break;
         }
 
-        player.position.x += deltaX * player.speed * deltaTime;
-        player.position.y += deltaY * player.speed * deltaTime;
+        player.position += GetDirectionVector(player.direction) * player.speed * deltaTime;
     }
 
-    void DrawPlayer(Player& player, sf::RenderWindow& window)
+    void DrawPlayer(PlayerSprite& playerSprite, const Position2D& position, const sf::Texture& texture, RenderQueue& queue)
     {
-        player.sprite.setPosition(player.position.x, player.position.y);
-        window.draw(player.sprite);
+        playerSprite.sprite.setPosition(position.x, position.y);
+
+        // Pushed as a plain quad, so it can share a draw call with other sprites of the atlas
+        const sf::Transform& transform = playerSprite.sprite.getTransform();
+        const sf::IntRect& textureRect = playerSprite.sprite.getTextureRect();
+        const float width = static_cast<float>(textureRect.width);
+        const float height = static_cast<float>(textureRect.height);
+        const float left = static_cast<float>(textureRect.left);
+        const float top = static_cast<float>(textureRect.top);
+
+        const sf::Vertex quad[4] =
+        {
+            {transform.transformPoint(0.f, 0.f), {left, top}},
+            {transform.transformPoint(width, 0.f), {left + width, top}},
+            {transform.transformPoint(width, height), {left + width, top + height}},
+            {transform.transformPoint(0.f, height), {left, top + height}}
+        };
+        PushQuads(queue, ERenderLayer::World, &texture, quad, 4);
     }
 
-    void RotatePlayer(Player& player)
+    void RotatePlayer(PlayerSprite& playerSprite, const MoveDirection direction)
     {
-        if (player.direction == MoveDirection::Left)
-        {
-            SetSpriteSize(player.sprite, -player.radius * 2.f, player.radius * 2.f);
-            player.sprite.setRotation(INITIAL_ANGLE);
-        }
-        else
-        {
-            SetSpriteSize(player.sprite, player.radius * 2.f, player.radius * 2.f);
-            player.sprite.setRotation(static_cast<float>(player.direction) * ROTATION_ANGLE);
-        }
+        if (playerSprite.direction == direction)
+            return;
+
+        const PlayerSpriteTransform& transform = playerSprite.transforms[static_cast<int>(direction)];
+        playerSprite.sprite.setScale(transform.scale);
+        playerSprite.sprite.setRotation(transform.rotation);
+        playerSprite.direction = direction;
     }
 }
@@ -2,11 +2,12 @@
 #include <SFML/Graphics.hpp>
 #include <string>
 #include "Math.h"
+#include "Constants.h"
+#include "Input.h"
+#include "RenderQueue.h"
 
 namespace ApplesGame
 {
-    struct Game;
-
     enum class MoveDirection
     {
         Right,
@@ -21,13 +22,29 @@ namespace ApplesGame
         const float ACCELERATION = 20.0f;
         const float INITIAL_SPEED = 200.0f;
         float speed = INITIAL_SPEED;
-        sf::Sprite sprite;
         MoveDirection direction = MoveDirection::None;
         std::string name;
     };
 
-    void InitializePlayer(Player& player, const Game& game);
-    void CalculatePlayerMovement(Player& player, const float deltaTime);
-    void DrawPlayer(Player& player, sf::RenderWindow& window);
-    void RotatePlayer(Player& player);
-}
\ No newline at end of file
+    struct PlayerSpriteTransform
+    {
+        sf::Vector2f scale;
+        float rotation = INITIAL_ANGLE;
+    };
+
+    // Player sprite with scale and rotation precomputed for every move direction
+    struct PlayerSprite
+    {
+        sf::Sprite sprite;
+        PlayerSpriteTransform transforms[static_cast<int>(MoveDirection::None) + 1];
+        MoveDirection direction = MoveDirection::None;
+    };
+
+    void InitializePlayer(Player& player);
+    void InitializePlayerSprite(PlayerSprite& playerSprite, const sf::IntRect& textureRect, float radius);
+    MoveDirection GetKeyDirection(sf::Keyboard::Key key);
+    Vector2D GetDirectionVector(MoveDirection direction);
+    void CalculatePlayerMovement(Player& player, const InputSnapshot& input, const float deltaTime);
+    void DrawPlayer(PlayerSprite& playerSprite, const Position2D& position, const sf::Texture& texture, RenderQueue& queue);
+    void RotatePlayer(PlayerSprite& playerSprite, MoveDirection direction);
+}
@@ -0,0 +1,238 @@
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include "Reachability.h"
+#include "Apple.h"
+#include "Rock.h"
+#include "Constants.h"
+#include "JobSystem.h"
+
+namespace ApplesGame
+{
+    namespace
+    {
+        constexpr int WORD_BITS = 64;
+
+        // Estimated nanoseconds per apple test, a few dozen grid cells each
+        constexpr float REACHED_CIRCLE_TEST_COST = 500.f;
+
+        // Spreads seed bits along the runs of set bits in mask, in both directions (Kogge-Stone fill)
+        uint64_t FillRuns(uint64_t seed, const uint64_t mask)
+        {
+            uint64_t up = seed & mask;
+            if (up == 0 || up == mask)
+                return up;
+
+            uint64_t upMask = mask;
+            uint64_t down = up;
+            uint64_t downMask = mask;
+
+            for (int shift = 1; shift < WORD_BITS; shift *= 2)
+            {
+                up |= upMask & (up << shift);
+                upMask &= upMask << shift;
+                down |= downMask & (down >> shift);
+                downMask &= downMask >> shift;
+            }
+
+            return up | down;
+        }
+
+        // Pulls reached cells from the neighbouring rows into this one and spreads them along the row
+        bool RelaxRow(OccupancyGrid& grid, const int row)
+        {
+            const int words = grid.wordsPerRow;
+            uint64_t* reached = &grid.reachedCells[row * words];
+            const uint64_t* freeCells = &grid.freeCells[row * words];
+            const uint64_t* above = row > 0 ? reached - words : nullptr;
+            const uint64_t* below = row + 1 < grid.height ? reached + words : nullptr;
+            bool isChanged = false;
+
+            uint64_t carry = 0;
+            for (int i = 0; i < words; ++i)
+            {
+                uint64_t seed = reached[i] | carry;
+                if (above)
+                    seed |= above[i];
+                if (below)
+                    seed |= below[i];
+
+                const uint64_t filled = FillRuns(seed, freeCells[i]);
+                isChanged |= filled != reached[i];
+                reached[i] = filled;
+                carry = filled >> (WORD_BITS - 1);
+            }
+
+            carry = 0;
+            for (int i = words - 1; i >= 0; --i)
+            {
+                const uint64_t filled = FillRuns(reached[i] | carry, freeCells[i]);
+                isChanged |= filled != reached[i];
+                reached[i] = filled;
+                carry = (filled & 1ull) << (WORD_BITS - 1);
+            }
+
+            return isChanged;
+        }
+
+        // Sets or clears cells first to last of a row, a word at a time
+        void FillCellRange(uint64_t* row, const int first, const int last, const bool isSet)
+        {
+            if (first > last)
+                return;
+
+            for (int word = first / WORD_BITS; word <= last / WORD_BITS; ++word)
+            {
+                const int low = std::max(first - word * WORD_BITS, 0);
+                const int high = std::min(last - word * WORD_BITS, WORD_BITS - 1);
+                const uint64_t mask = (~0ull >> (WORD_BITS - 1 - high)) & (~0ull << low);
+
+                if (isSet)
+                    row[word] |= mask;
+                else
+                    row[word] &= ~mask;
+            }
+        }
+
+        bool IsCellSet(const OccupancyGrid& grid, const std::vector<uint64_t>& cells, const int x, const int y)
+        {
+            return (cells[y * grid.wordsPerRow + x / WORD_BITS] >> (x % WORD_BITS)) & 1ull;
+        }
+
+        float GetCellCenter(const OccupancyGrid& grid, const int index)
+        {
+            return (static_cast<float>(index) + 0.5f) * grid.cellSize;
+        }
+    }
+
+    void RasterizeOccupancyGrid(OccupancyGrid& grid, const std::vector<Rock>& rocks, const float actorRadius,
+                                const float fieldWidth, const float fieldHeight, const float cellSize)
+    {
+        grid.cellSize = cellSize;
+        grid.width = static_cast<int>(fieldWidth / cellSize);
+        grid.height = static_cast<int>(fieldHeight / cellSize);
+        grid.wordsPerRow = (grid.width + WORD_BITS - 1) / WORD_BITS;
+        grid.freeCells.assign(grid.wordsPerRow * grid.height, 0);
+        grid.reachedCells.assign(grid.wordsPerRow * grid.height, 0);
+
+        // Cells whose center keeps the actor inside the field bounds
+        const int minX = std::max(0, static_cast<int>(std::floor(actorRadius / cellSize - 0.5f)) + 1);
+        const int maxX = std::min(grid.width - 1, static_cast<int>(std::ceil((fieldWidth - actorRadius) / cellSize - 0.5f)) - 1);
+        const int minY = std::max(0, static_cast<int>(std::floor(actorRadius / cellSize - 0.5f)) + 1);
+        const int maxY = std::min(grid.height - 1, static_cast<int>(std::ceil((fieldHeight - actorRadius) / cellSize - 0.5f)) - 1);
+
+        for (int y = minY; y <= maxY; ++y)
+            FillCellRange(&grid.freeCells[y * grid.wordsPerRow], minX, maxX, true);
+
+        // Rocks are inflated by the actor radius, so a free cell means the actor fits there
+        for (const Rock& rock : rocks)
+        {
+            const int left = std::max(0, static_cast<int>(std::floor((rock.position.x - actorRadius) / cellSize - 0.5f)));
+            const int right = std::min(grid.width - 1, static_cast<int>(std::ceil((rock.position.x + rock.size.x + actorRadius) / cellSize - 0.5f)));
+            const int top = std::max(0, static_cast<int>(std::floor((rock.position.y - actorRadius) / cellSize - 0.5f)));
+            const int bottom = std::min(grid.height - 1, static_cast<int>(std::ceil((rock.position.y + rock.size.y + actorRadius) / cellSize - 0.5f)));
+
+            for (int y = top; y <= bottom; ++y)
+                FillCellRange(&grid.freeCells[y * grid.wordsPerRow], left, right, false);
+        }
+    }
+
+    void FloodFillOccupancyGrid(OccupancyGrid& grid, const Position2D& start)
+    {
+        std::fill(grid.reachedCells.begin(), grid.reachedCells.end(), 0);
+
+        const int startX = static_cast<int>(start.x / grid.cellSize);
+        const int startY = static_cast<int>(start.y / grid.cellSize);
+
+        if (startX < 0 || startX >= grid.width || startY < 0 || startY >= grid.height ||
+            !IsCellSet(grid, grid.freeCells, startX, startY))
+        {
+            return;
+        }
+
+        grid.reachedCells[startY * grid.wordsPerRow + startX / WORD_BITS] |= 1ull << (startX % WORD_BITS);
+
+        // Only rows next to a changed row can change, so the sweeps skip the settled ones
+        grid.dirtyRows.assign(grid.height, 0);
+        int dirtyRowsCount = 0;
+        const auto markRow = [&grid, &dirtyRowsCount](const int y)
+        {
+            if (y >= 0 && y < grid.height && !grid.dirtyRows[y])
+            {
+                grid.dirtyRows[y] = 1;
+                ++dirtyRowsCount;
+            }
+        };
+        const auto relaxDirtyRow = [&grid, &dirtyRowsCount, &markRow](const int y)
+        {
+            if (!grid.dirtyRows[y])
+                return;
+
+            grid.dirtyRows[y] = 0;
+            --dirtyRowsCount;
+            if (RelaxRow(grid, y))
+            {
+                markRow(y - 1);
+                markRow(y + 1);
+            }
+        };
+
+        markRow(startY - 1);
+        markRow(startY);
+        markRow(startY + 1);
+
+        while (dirtyRowsCount > 0)
+        {
+            for (int y = 0; y < grid.height; ++y)
+                relaxDirtyRow(y);
+
+            for (int y = grid.height - 1; y >= 0; --y)
+                relaxDirtyRow(y);
+        }
+    }
+
+    bool IsCircleReached(const OccupancyGrid& grid, const Circle& circle, const float actorRadius)
+    {
+        const float touchDistance = circle.radius + actorRadius;
+        const int left = std::max(0, static_cast<int>((circle.position.x - touchDistance) / grid.cellSize));
+        const int right = std::min(grid.width - 1, static_cast<int>((circle.position.x + touchDistance) / grid.cellSize));
+        const int top = std::max(0, static_cast<int>((circle.position.y - touchDistance) / grid.cellSize));
+        const int bottom = std::min(grid.height - 1, static_cast<int>((circle.position.y + touchDistance) / grid.cellSize));
+
+        for (int y = top; y <= bottom; ++y)
+        {
+            for (int x = left; x <= right; ++x)
+            {
+                if (!IsCellSet(grid, grid.reachedCells, x, y))
+                    continue;
+
+                const Circle cell = {{GetCellCenter(grid, x), GetCellCenter(grid, y)}, actorRadius};
+                if (CheckCircleCollision(cell, circle))
+                    return true;
+            }
+        }
+
+        return false;
+    }
+
+    bool AreApplesReachable(OccupancyGrid& grid, const Circle& actor, const std::vector<Apple>& apples,
+                            const std::vector<Rock>& rocks, const float fieldWidth, const float fieldHeight)
+    {
+        RasterizeOccupancyGrid(grid, rocks, actor.radius, fieldWidth, fieldHeight, REACHABILITY_CELL_SIZE);
+        FloodFillOccupancyGrid(grid, actor.position);
+
+        // The filled grid is read only from here on, so the apples are tested independently
+        std::atomic<bool> isEveryAppleReached{true};
+        ParallelFor(GetJobSystem(), apples.size(), REACHED_CIRCLE_TEST_COST,
+            [&grid, &apples, &actor, &isEveryAppleReached](const size_t begin, const size_t end)
+            {
+                for (size_t i = begin; i < end && isEveryAppleReached; ++i)
+                {
+                    if (!apples[i].isEaten && !IsCircleReached(grid, apples[i], actor.radius))
+                        isEveryAppleReached = false;
+                }
+            });
+
+        return isEveryAppleReached;
+    }
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "Math.h"
+
+namespace ApplesGame
+{
+    struct Apple;
+    struct Rock;
+
+    // One bit per cell, 64 cells packed in a word, rows padded to whole words
+    struct OccupancyGrid
+    {
+        int width = 0;
+        int height = 0;
+        int wordsPerRow = 0;
+        float cellSize = 1.f;
+        std::vector<uint64_t> freeCells;
+        std::vector<uint64_t> reachedCells;
+        std::vector<uint8_t> dirtyRows;
+    };
+
+    void RasterizeOccupancyGrid(OccupancyGrid& grid, const std::vector<Rock>& rocks, float actorRadius,
+                                float fieldWidth, float fieldHeight, float cellSize);
+    void FloodFillOccupancyGrid(OccupancyGrid& grid, const Position2D& start);
+    bool IsCircleReached(const OccupancyGrid& grid, const Circle& circle, float actorRadius);
+    // The grid is only scratch storage, pass the same one to reuse its buffers between calls
+    bool AreApplesReachable(OccupancyGrid& grid, const Circle& actor, const std::vector<Apple>& apples,
+                            const std::vector<Rock>& rocks, float fieldWidth, float fieldHeight);
+}
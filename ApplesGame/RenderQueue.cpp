@@ -0,0 +1,110 @@
+#include <algorithm>
+#include "RenderQueue.h"
+
+namespace ApplesGame
+{
+    namespace
+    {
+        uint32_t GetBlendKey(const sf::BlendMode& blendMode)
+        {
+            return static_cast<uint32_t>(blendMode.colorSrcFactor) | static_cast<uint32_t>(blendMode.colorDstFactor) << 4 |
+                static_cast<uint32_t>(blendMode.colorEquation) << 8 | static_cast<uint32_t>(blendMode.alphaSrcFactor) << 12 |
+                static_cast<uint32_t>(blendMode.alphaDstFactor) << 16 | static_cast<uint32_t>(blendMode.alphaEquation) << 20;
+        }
+
+        bool IsSameMaterial(const RenderCommand& command, const RenderCommand& other)
+        {
+            return command.texture == other.texture && command.blendKey == other.blendKey;
+        }
+
+        bool IsDrawnBefore(const RenderCommand& command, const RenderCommand& other)
+        {
+            if (command.layer != other.layer)
+                return command.layer < other.layer;
+            if (command.texture != other.texture)
+                return std::less<const sf::Texture*>()(command.texture, other.texture);
+            return command.blendKey < other.blendKey;
+        }
+
+        void PushCommand(RenderQueue& queue, RenderCommand& command, const sf::Texture* texture, const sf::BlendMode& blendMode)
+        {
+            command.texture = texture;
+            command.blendMode = blendMode;
+            command.blendKey = GetBlendKey(blendMode);
+            queue.commands.push_back(command);
+        }
+    }
+
+    void ClearRenderQueue(RenderQueue& queue)
+    {
+        queue.commands.clear();
+        queue.vertices.clear();
+        queue.drawCallsCount = 0;
+        queue.stateChangesCount = 0;
+    }
+
+    void PushQuads(RenderQueue& queue, const ERenderLayer layer, const sf::Texture* texture, const sf::Vertex* vertices,
+                   const size_t verticesCount, const sf::BlendMode& blendMode)
+    {
+        RenderCommand command;
+        command.layer = layer;
+        command.firstVertex = queue.vertices.size();
+        command.verticesCount = verticesCount;
+        queue.vertices.insert(queue.vertices.end(), vertices, vertices + verticesCount);
+        PushCommand(queue, command, texture, blendMode);
+    }
+
+    void PushDrawable(RenderQueue& queue, const ERenderLayer layer, const sf::Drawable& drawable, const sf::Texture* texture,
+                      const sf::BlendMode& blendMode)
+    {
+        RenderCommand command;
+        command.layer = layer;
+        command.drawable = &drawable;
+        PushCommand(queue, command, texture, blendMode);
+    }
+
+    void SubmitRenderQueue(RenderQueue& queue, sf::RenderTarget& target, const ERenderLayer firstLayer,
+                           const ERenderLayer lastLayer)
+    {
+        // Stable, so commands of one material keep the order they were pushed in
+        std::stable_sort(queue.commands.begin(), queue.commands.end(), IsDrawnBefore);
+
+        const RenderCommand* previous = nullptr;
+
+        for (size_t i = 0; i < queue.commands.size();)
+        {
+            const RenderCommand& command = queue.commands[i];
+            if (command.layer < firstLayer || command.layer > lastLayer)
+            {
+                ++i;
+                continue;
+            }
+
+            const sf::RenderStates states(command.blendMode, sf::Transform::Identity, command.texture, nullptr);
+
+            if (!previous || !IsSameMaterial(*previous, command))
+                ++queue.stateChangesCount;
+            previous = &command;
+            ++queue.drawCallsCount;
+
+            if (command.drawable)
+            {
+                target.draw(*command.drawable, states);
+                ++i;
+                continue;
+            }
+
+            // Neighbouring quads of the same material go to the GPU in one draw call
+            queue.batchVertices.clear();
+            for (; i < queue.commands.size() && !queue.commands[i].drawable && queue.commands[i].layer == command.layer &&
+                IsSameMaterial(queue.commands[i], command); ++i)
+            {
+                const sf::Vertex* vertices = &queue.vertices[queue.commands[i].firstVertex];
+                queue.batchVertices.insert(queue.batchVertices.end(), vertices, vertices + queue.commands[i].verticesCount);
+            }
+
+            if (!queue.batchVertices.empty())
+                target.draw(queue.batchVertices.data(), queue.batchVertices.size(), sf::Quads, states);
+        }
+    }
+}
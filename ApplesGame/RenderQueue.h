@@ -0,0 +1,46 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <vector>
+
+namespace ApplesGame
+{
+    // Layers keep the painter's order between groups, inside a layer commands are ordered by material
+    enum class ERenderLayer : uint8_t
+    {
+        World,
+        Effects,
+        Interface
+    };
+
+    struct RenderCommand
+    {
+        ERenderLayer layer = ERenderLayer::World;
+        const sf::Texture* texture = nullptr;
+        sf::BlendMode blendMode;
+        uint32_t blendKey = 0;
+
+        // Drawn as is when set, otherwise the command owns quads in the queue vertices
+        const sf::Drawable* drawable = nullptr;
+        size_t firstVertex = 0;
+        size_t verticesCount = 0;
+    };
+
+    // Draw commands of one frame, sorted by material and merged into as few draw calls as possible on submit
+    struct RenderQueue
+    {
+        std::vector<RenderCommand> commands;
+        std::vector<sf::Vertex> vertices;
+        std::vector<sf::Vertex> batchVertices;
+        int drawCallsCount = 0;
+        int stateChangesCount = 0;
+    };
+
+    void ClearRenderQueue(RenderQueue& queue);
+    void PushQuads(RenderQueue& queue, ERenderLayer layer, const sf::Texture* texture, const sf::Vertex* vertices,
+                   size_t verticesCount, const sf::BlendMode& blendMode = sf::BlendAlpha);
+    void PushDrawable(RenderQueue& queue, ERenderLayer layer, const sf::Drawable& drawable, const sf::Texture* texture,
+                      const sf::BlendMode& blendMode = sf::BlendAlpha);
+    void SubmitRenderQueue(RenderQueue& queue, sf::RenderTarget& target, ERenderLayer firstLayer = ERenderLayer::World,
+                           ERenderLayer lastLayer = ERenderLayer::Interface);
+}
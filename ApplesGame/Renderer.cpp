@@ -0,0 +1,380 @@
+#include <algorithm>
+#include "Renderer.h"
+#include "ResourceCache.h"
+#include "StartupProfile.h"
+
+namespace ApplesGame
+{
+    namespace
+    {
+        // Rebuilds the level geometry once per level, afterwards only re-uploads apples that changed
+        void SyncWorld(Renderer& renderer, const RenderSnapshot& snapshot)
+        {
+            if (renderer.drawnLevelIndex != snapshot.levelIndex)
+            {
+                const AtlasRegions& regions = renderer.textureAtlas.regions;
+                InitializePlayerSprite(renderer.playerSprite, GetAtlasRegion(regions, PLAYER_TEXTURE_NAME), snapshot.player.radius);
+                InitializeApplesBatch(renderer.applesBatch, snapshot.apples, GetAtlasRegion(regions, APPLE_TEXTURE_NAME));
+                InitializeRocksBatch(renderer.rocksBatch, snapshot.rocks, GetAtlasRegion(regions, ROCK_TEXTURE_NAME));
+                renderer.drawnApples = snapshot.apples;
+                renderer.drawnLevelIndex = snapshot.levelIndex;
+                return;
+            }
+
+            for (size_t i = 0; i < snapshot.apples.size(); ++i)
+            {
+                const Apple& apple = snapshot.apples[i];
+                Apple& drawnApple = renderer.drawnApples[i];
+
+                if (apple.isEaten != drawnApple.isEaten || apple.position != drawnApple.position)
+                {
+                    drawnApple = apple;
+                    UpdateAppleQuad(renderer.applesBatch, apple, i);
+                }
+            }
+        }
+
+        // Playing and game over screens move every frame, the others only change with a new snapshot
+        bool IsAnimatedSnapshot(const RenderSnapshot& snapshot)
+        {
+            return snapshot.gameState == EGameState::Playing || snapshot.gameState == EGameState::EndGame;
+        }
+
+        bool ReadLatchedDirection(Renderer& renderer, const RenderSnapshot& snapshot, MoveDirection& direction, sf::Time& eventTime)
+        {
+            std::lock_guard<std::mutex> lock(renderer.latchedInput.mutex);
+            if (renderer.latchedInput.direction == MoveDirection::None || renderer.latchedInput.eventTime <= snapshot.inputTime)
+                return false;
+
+            direction = renderer.latchedInput.direction;
+            eventTime = renderer.latchedInput.eventTime;
+            return true;
+        }
+
+        void DrawLowLatencyGame(Renderer& renderer, const RenderSnapshot& snapshot)
+        {
+            const sf::Time renderTime = GetTimeSinceProcessStart();
+            MoveDirection direction = snapshot.playerDirection;
+            sf::Time turnTime = renderTime;
+
+            if (renderer.isLateLatchEnabled && ReadLatchedDirection(renderer, snapshot, direction, turnTime))
+                renderer.drawnLatchedEventTime = std::max(renderer.drawnLatchedEventTime, turnTime);
+
+            DrawGame(renderer, snapshot, GetExtrapolatedPlayerPosition(snapshot, direction, turnTime, renderTime), direction);
+        }
+
+        void RecordInputLatency(Renderer& renderer, const RenderSnapshot& snapshot)
+        {
+            InputLatencyStats& stats = renderer.inputLatency;
+            std::vector<sf::Time>& latchedEventTimes = renderer.latchedDisplayedEventTimes;
+            for (const InputLatencySample& sample : snapshot.inputLatencySamples)
+            {
+                stats.eventToTickMicroseconds.push_back((sample.tickTime - sample.eventTime).asMicroseconds());
+
+                // Late latching already put this very press on screen before its tick
+                if (std::find(latchedEventTimes.begin(), latchedEventTimes.end(), sample.eventTime) != latchedEventTimes.end())
+                    continue;
+
+                stats.tickToDisplayMicroseconds.push_back((renderer.displayTime - sample.tickTime).asMicroseconds());
+                stats.eventToDisplayMicroseconds.push_back((renderer.displayTime - sample.eventTime).asMicroseconds());
+            }
+
+            // Presses up to the snapshot's input time are simulated now, no later sample can match them
+            latchedEventTimes.erase(std::remove_if(latchedEventTimes.begin(), latchedEventTimes.end(), [&snapshot](const sf::Time eventTime)
+                {
+                    return eventTime <= snapshot.inputTime;
+                }), latchedEventTimes.end());
+        }
+
+        void ApplyReloadedAssets(Renderer& renderer)
+        {
+            // The taken versions stay alive until the atlas and the interface have acquired them
+            const std::vector<ReloadedAsset> images = TakeReloadedAssets(*renderer.assetWatcher, EAssetKind::Image);
+            if (!images.empty())
+            {
+                std::vector<std::string> imageNames;
+                for (const ReloadedAsset& image : images)
+                    imageNames.push_back(GetArchivedAssetName(image.path));
+
+                bool isRepacked = false;
+                if (UpdateTextureAtlas(renderer.textureAtlas, ATLAS_TEXTURE_NAMES, imageNames, isRepacked) && isRepacked)
+                {
+                    // Regions moved, so every quad is rebuilt against the new layout
+                    renderer.drawnLevelIndex = -1;
+                }
+            }
+
+            const std::vector<ReloadedAsset> fonts = TakeReloadedAssets(*renderer.assetWatcher, EAssetKind::Font);
+            if (!fonts.empty())
+                SetUserInterfaceFont(renderer.ui, AcquireResource(GetFontCache(), RESOURCES_PATH + FONT_NAME));
+        }
+    }
+
+    bool LoadRendererResources(Renderer& renderer)
+    {
+        if (!BuildTextureAtlas(renderer.textureAtlas, ATLAS_TEXTURE_NAMES))
+            return false;
+
+        renderer.playerSprite.sprite.setTexture(renderer.textureAtlas.texture);
+        return true;
+    }
+
+    void InitializeRenderer(Renderer& renderer)
+    {
+        InitializeUserInterface(renderer.ui);
+        InitializeParticlePool(renderer.particles, PARTICLES_CAPACITY);
+        InitializeDynamicResolution(renderer.resolution, SCREEN_WIDTH, SCREEN_HEIGHT, DYNAMIC_RESOLUTION_TARGET_FRAME_RATE);
+        InitializeFramePacer(renderer.framePacer, RENDER_FRAME_RATE);
+    }
+
+    void FillRenderSnapshot(const Game& game, RenderSnapshot& snapshot)
+    {
+        snapshot.gameState = game.gameState;
+        snapshot.mode = game.mode;
+        snapshot.levelIndex = game.levelIndex;
+        snapshot.player = game.player;
+        snapshot.playerDirection = game.player.direction;
+        snapshot.playerSpeed = game.player.speed;
+        snapshot.apples = game.apples;
+        snapshot.rocks = game.rocks;
+        snapshot.eatenApplesCount = game.eatenApplesCount;
+        snapshot.isHintVisible = game.isHintVisible;
+        snapshot.particleBursts = game.particleBursts;
+        snapshot.inputTime = game.tickInput.time;
+        snapshot.inputLatencySamples = game.inputLatencySamples;
+
+        if (game.gameState == EGameState::Scoreboard)
+            snapshot.message = game.scoreboardMessage;
+        else if (game.gameState == EGameState::EndGame)
+            snapshot.message = game.endGameMessage;
+        else
+            snapshot.message.clear();
+    }
+
+    void PublishRenderSnapshot(SnapshotExchange& exchange, RenderSnapshot& snapshot)
+    {
+        {
+            std::lock_guard<std::mutex> lock(exchange.mutex);
+
+            // Bursts and input of a snapshot the render thread skipped still have to be spawned and measured
+            if (exchange.isSnapshotPending)
+            {
+                const std::vector<ParticleBurst>& skippedBursts = exchange.pendingSnapshot.particleBursts;
+                snapshot.particleBursts.insert(snapshot.particleBursts.end(), skippedBursts.begin(), skippedBursts.end());
+
+                const std::vector<InputLatencySample>& skippedSamples = exchange.pendingSnapshot.inputLatencySamples;
+                snapshot.inputLatencySamples.insert(snapshot.inputLatencySamples.begin(), skippedSamples.begin(), skippedSamples.end());
+            }
+
+            std::swap(exchange.pendingSnapshot, snapshot);
+            exchange.isSnapshotPending = true;
+        }
+
+        exchange.condition.notify_one();
+    }
+
+    // Returns false once the render thread has to stop
+    bool AcquireRenderSnapshot(SnapshotExchange& exchange, RenderSnapshot& snapshot, const bool isBlocking, bool& isAcquired)
+    {
+        std::unique_lock<std::mutex> lock(exchange.mutex);
+        if (isBlocking)
+        {
+            exchange.condition.wait(lock, [&exchange]()
+                {
+                    return exchange.isSnapshotPending || exchange.isStopRequested;
+                });
+        }
+
+        isAcquired = false;
+        if (exchange.isStopRequested)
+            return false;
+
+        if (exchange.isSnapshotPending)
+        {
+            std::swap(exchange.pendingSnapshot, snapshot);
+            exchange.isSnapshotPending = false;
+            isAcquired = true;
+        }
+
+        return true;
+    }
+
+    void StopRenderThread(SnapshotExchange& exchange)
+    {
+        {
+            std::lock_guard<std::mutex> lock(exchange.mutex);
+            exchange.isStopRequested = true;
+        }
+
+        exchange.condition.notify_one();
+    }
+
+    void RunRenderThread(sf::RenderWindow& window, Renderer& renderer, SnapshotExchange& exchange)
+    {
+        window.setActive(true);
+
+        RenderSnapshot previousSnapshot;
+        RenderSnapshot snapshot;
+        RenderSnapshot acquiredSnapshot;
+        bool isAcquired = false;
+
+        // Moving scenes are drawn at the render frame rate in between ticks, still ones wait for the next tick
+        while (true)
+        {
+            const bool isAnimated = IsAnimatedSnapshot(snapshot);
+            if (isAnimated)
+                WaitForNextFrame(renderer.framePacer);
+
+            if (!AcquireRenderSnapshot(exchange, acquiredSnapshot, !isAnimated, isAcquired))
+                break;
+
+            if (isAcquired)
+            {
+                std::swap(previousSnapshot, snapshot);
+                std::swap(snapshot, acquiredSnapshot);
+
+                for (const ParticleBurst& burst : snapshot.particleBursts)
+                    EmitParticleBurst(renderer.particles, burst);
+            }
+
+            if (!isAnimated && IsAnimatedSnapshot(snapshot))
+                RestartFramePacer(renderer.framePacer);
+
+            DrawFrame(window, renderer, previousSnapshot, snapshot);
+            if (isAcquired)
+                RecordInputLatency(renderer, snapshot);
+        }
+
+        window.setActive(false);
+    }
+
+    // Drawn a tick behind the simulation, so there are always two ticks to blend the player between
+    Position2D GetInterpolatedPlayerPosition(const RenderSnapshot& previousSnapshot, const RenderSnapshot& snapshot,
+                                             const sf::Time renderTime)
+    {
+        if (previousSnapshot.levelIndex != snapshot.levelIndex || previousSnapshot.gameState != snapshot.gameState ||
+            snapshot.time <= previousSnapshot.time)
+        {
+            return snapshot.player.position;
+        }
+
+        const float blend = std::min(std::max((renderTime - previousSnapshot.time) / (snapshot.time - previousSnapshot.time), 0.f), 1.f);
+        return previousSnapshot.player.position + (snapshot.player.position - previousSnapshot.player.position) * blend;
+    }
+
+    // The newest tick moved on by at most a tick, the next snapshot is due by then; a latched press turns the player at turnTime
+    Position2D GetExtrapolatedPlayerPosition(const RenderSnapshot& snapshot, const MoveDirection direction, sf::Time turnTime,
+                                             const sf::Time renderTime)
+    {
+        const sf::Time endTime = std::min(renderTime, snapshot.time + sf::seconds(1.f / SIMULATION_TICK_RATE));
+        if (endTime <= snapshot.time)
+            return snapshot.player.position;
+
+        turnTime = std::min(std::max(turnTime, snapshot.time), endTime);
+        return snapshot.player.position +
+            GetDirectionVector(snapshot.playerDirection) * snapshot.playerSpeed * (turnTime - snapshot.time).asSeconds() +
+            GetDirectionVector(direction) * snapshot.playerSpeed * (endTime - turnTime).asSeconds();
+    }
+
+    // Called by the event thread after polling, so the render thread sees presses as soon as they are read
+    void LatchPlayerInput(LatchedInput& latch, const InputState& input)
+    {
+        for (auto event = input.pendingEvents.rbegin(); event != input.pendingEvents.rend(); ++event)
+        {
+            const MoveDirection direction = GetKeyDirection(event->key);
+            if (event->isPressed && direction != MoveDirection::None)
+            {
+                std::lock_guard<std::mutex> lock(latch.mutex);
+                latch.direction = direction;
+                latch.eventTime = event->time;
+                return;
+            }
+        }
+    }
+
+    void DrawGame(Renderer& renderer, const RenderSnapshot& snapshot, const Position2D& playerPosition,
+                  const MoveDirection playerDirection)
+    {
+        UpdateScoreLabel(renderer.ui, snapshot.eatenApplesCount);
+        RotatePlayer(renderer.playerSprite, playerDirection);
+
+        DrawPlayer(renderer.playerSprite, playerPosition, renderer.textureAtlas.texture, renderer.queue);
+        DrawSpriteBatch(renderer.applesBatch, renderer.textureAtlas.texture, renderer.queue);
+        DrawSpriteBatch(renderer.rocksBatch, renderer.textureAtlas.texture, renderer.queue);
+        DrawParticles(renderer.particles, renderer.queue);
+
+        DrawLabel(renderer.ui.scoreLabel, renderer.queue);
+
+        if (snapshot.isHintVisible)
+            DrawLabel(renderer.ui.hintLabel, renderer.queue);
+    }
+
+    void DrawFrame(sf::RenderWindow& window, Renderer& renderer, const RenderSnapshot& previousSnapshot,
+                   const RenderSnapshot& snapshot)
+    {
+        renderer.frameClock.restart();
+        if (renderer.assetWatcher)
+            ApplyReloadedAssets(renderer);
+
+        SyncWorld(renderer, snapshot);
+        if (renderer.stressParticlesCount > 0)
+            KeepParticlesAlive(renderer.particles, renderer.stressParticlesCount, {0.f, 0.f, SCREEN_WIDTH, SCREEN_HEIGHT});
+        UpdateParticles(renderer.particles, renderer.particlesClock.restart().asSeconds());
+
+        ClearRenderQueue(renderer.queue);
+
+        switch (snapshot.gameState)
+        {
+            case EGameState::MainMenu:
+                ShowMenu(renderer.ui, snapshot.mode, renderer.queue);
+                break;
+            case EGameState::Playing:
+                if (renderer.isLowLatencyEnabled)
+                {
+                    DrawLowLatencyGame(renderer, snapshot);
+                }
+                else
+                {
+                    DrawGame(renderer, snapshot, GetInterpolatedPlayerPosition(previousSnapshot, snapshot,
+                        GetTimeSinceProcessStart() - sf::seconds(1.f / SIMULATION_TICK_RATE)), snapshot.playerDirection);
+                }
+                break;
+            case EGameState::EndGame:
+                DisplayMessage(renderer.ui, snapshot.message, renderer.queue);
+                DrawParticles(renderer.particles, renderer.queue);
+                break;
+            case EGameState::Scoreboard:
+                DisplayMessage(renderer.ui, snapshot.message, renderer.queue);
+                break;
+            default:
+                break;
+        }
+
+        // World and effects follow the dynamic resolution, the interface stays sharp at native resolution
+        window.clear();
+        SubmitRenderQueue(renderer.queue, BeginDynamicResolutionFrame(renderer.resolution, window),
+            ERenderLayer::World, ERenderLayer::Effects);
+        PresentDynamicResolutionFrame(renderer.resolution, window);
+        SubmitRenderQueue(renderer.queue, window, ERenderLayer::Interface, ERenderLayer::Interface);
+
+        // Read before the swap, a present blocked on vsync is not a frame over budget
+        const sf::Time frameTime = renderer.frameClock.getElapsedTime();
+        renderer.framesTime += frameTime;
+        ++renderer.drawnFramesCount;
+        window.display();
+        renderer.displayTime = GetTimeSinceProcessStart();
+
+        if (renderer.drawnLatchedEventTime > renderer.displayedLatchedEventTime)
+        {
+            renderer.inputLatency.eventToDisplayMicroseconds.push_back(
+                (renderer.displayTime - renderer.drawnLatchedEventTime).asMicroseconds());
+            renderer.displayedLatchedEventTime = renderer.drawnLatchedEventTime;
+            renderer.latchedDisplayedEventTimes.push_back(renderer.drawnLatchedEventTime);
+        }
+
+        if (renderer.firstFrameMicroseconds < 0)
+            renderer.firstFrameMicroseconds = GetTimeSinceProcessStart().asMicroseconds();
+
+        UpdateDynamicResolution(renderer.resolution, frameTime.asSeconds());
+    }
+}
@@ -0,0 +1,128 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "AssetWatcher.h"
+#include "DynamicResolution.h"
+#include "FramePacer.h"
+#include "Game.h"
+#include "Input.h"
+#include "Particles.h"
+#include "RenderQueue.h"
+#include "SpriteBatch.h"
+#include "TextureAtlas.h"
+#include "UI.h"
+
+namespace ApplesGame
+{
+    // Copy of everything one simulation tick shows on screen, the render thread never touches Game
+    struct RenderSnapshot
+    {
+        EGameState gameState = EGameState::None;
+        uint8_t mode = DEFAULT_MODE;
+        int levelIndex = 0;
+        Circle player;
+        MoveDirection playerDirection = MoveDirection::None;
+        float playerSpeed = 0.f;
+        std::vector<Apple> apples;
+        std::vector<Rock> rocks;
+        int eatenApplesCount = 0;
+        bool isHintVisible = true;
+        std::string message;
+        std::vector<ParticleBurst> particleBursts;
+
+        // When this state was current, on the GetTimeSinceProcessStart clock
+        sf::Time time;
+
+        // Key events up to inputTime are simulated in this state
+        sf::Time inputTime;
+        std::vector<InputLatencySample> inputLatencySamples;
+    };
+
+    // Newest direction press read by the event thread, drawn by the render thread before the simulation consumed it
+    struct LatchedInput
+    {
+        std::mutex mutex;
+        MoveDirection direction = MoveDirection::None;
+        sf::Time eventTime;
+    };
+
+    // The simulation swaps its filled snapshot in, the render thread swaps the latest one out
+    struct SnapshotExchange
+    {
+        std::mutex mutex;
+        std::condition_variable condition;
+        RenderSnapshot pendingSnapshot;
+        bool isSnapshotPending = false;
+        bool isStopRequested = false;
+    };
+
+    // Everything that lives on the GPU or is only needed for drawing, owned by the render thread
+    struct Renderer
+    {
+        TextureAtlas textureAtlas;
+        PlayerSprite playerSprite;
+        SpriteBatch applesBatch;
+        SpriteBatch rocksBatch;
+
+        int drawnLevelIndex = -1;
+        std::vector<Apple> drawnApples;
+
+        ParticlePool particles;
+        sf::Clock particlesClock;
+
+        // Live particles kept on screen as a stress load while measuring frame times, 0 for none
+        size_t stressParticlesCount = 0;
+        RenderQueue queue;
+        DynamicResolution resolution;
+        sf::Clock frameClock;
+
+        // CPU time of every drawn frame up to the swap, printed as an average at exit
+        sf::Time framesTime;
+        int drawnFramesCount = 0;
+        FramePacer framePacer;
+
+        // Time since process start when the first frame reached the screen, negative until then
+        std::atomic<sf::Int64> firstFrameMicroseconds{-1};
+
+        UserInterface ui;
+
+        // Low latency mode draws the newest tick moved on to the present instead of blending a tick behind,
+        // late latching also steers the drawn player with presses the simulation has not reached yet
+        bool isLowLatencyEnabled = false;
+        bool isLateLatchEnabled = false;
+        LatchedInput latchedInput;
+        sf::Time drawnLatchedEventTime;
+        sf::Time displayedLatchedEventTime;
+
+        // Presses already put on screen by late latching, until the snapshot that simulated them arrives
+        std::vector<sf::Time> latchedDisplayedEventTimes;
+
+        // Written by the render thread, read once it has stopped
+        InputLatencyStats inputLatency;
+        sf::Time displayTime;
+
+        // Set while assets are reloaded live, edited images and fonts are swapped in at the start of a frame
+        AssetWatcher* assetWatcher = nullptr;
+    };
+
+    bool LoadRendererResources(Renderer& renderer);
+    void InitializeRenderer(Renderer& renderer);
+    void FillRenderSnapshot(const Game& game, RenderSnapshot& snapshot);
+    void PublishRenderSnapshot(SnapshotExchange& exchange, RenderSnapshot& snapshot);
+    bool AcquireRenderSnapshot(SnapshotExchange& exchange, RenderSnapshot& snapshot, bool isBlocking, bool& isAcquired);
+    void StopRenderThread(SnapshotExchange& exchange);
+    void RunRenderThread(sf::RenderWindow& window, Renderer& renderer, SnapshotExchange& exchange);
+    Position2D GetInterpolatedPlayerPosition(const RenderSnapshot& previousSnapshot, const RenderSnapshot& snapshot,
+                                             sf::Time renderTime);
+    Position2D GetExtrapolatedPlayerPosition(const RenderSnapshot& snapshot, MoveDirection direction, sf::Time turnTime,
+                                             sf::Time renderTime);
+    void LatchPlayerInput(LatchedInput& latch, const InputState& input);
+    void DrawGame(Renderer& renderer, const RenderSnapshot& snapshot, const Position2D& playerPosition,
+                  MoveDirection playerDirection);
+    void DrawFrame(sf::RenderWindow& window, Renderer& renderer, const RenderSnapshot& previousSnapshot,
+                   const RenderSnapshot& snapshot);
+}
@@ -0,0 +1,32 @@
+#include "ResourceCache.h"
+#include "Constants.h"
+
+namespace ApplesGame
+{
+    std::string GetArchivedAssetName(const std::string& path)
+    {
+        size_t nameStart = path.compare(0, RESOURCES_PATH.size(), RESOURCES_PATH) == 0 ? RESOURCES_PATH.size() : 0;
+        while (nameStart < path.size() && path[nameStart] == '/')
+            ++nameStart;
+
+        return path.substr(nameStart);
+    }
+
+    ResourceCache<sf::Font>& GetFontCache()
+    {
+        static ResourceCache<sf::Font> cache;
+        return cache;
+    }
+
+    ResourceCache<sf::Image>& GetImageCache()
+    {
+        static ResourceCache<sf::Image> cache;
+        return cache;
+    }
+
+    ResourceCache<sf::SoundBuffer>& GetSoundBufferCache()
+    {
+        static ResourceCache<sf::SoundBuffer> cache;
+        return cache;
+    }
+}
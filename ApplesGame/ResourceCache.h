@@ -0,0 +1,103 @@
+#pragma once
+#include <SFML/Audio/SoundBuffer.hpp>
+#include <SFML/Graphics.hpp>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include "AssetArchive.h"
+#include "DecodedAssetCache.h"
+#include "MappedFile.h"
+
+namespace ApplesGame
+{
+    // Assets keyed by path, loaded once and freed when the last holder lets go of them
+    template <typename Resource>
+    struct ResourceCache
+    {
+        std::mutex mutex;
+        std::unordered_map<std::string, std::weak_ptr<const Resource>> resources;
+        int loadsCount = 0;
+    };
+
+    std::string GetArchivedAssetName(const std::string& path);
+
+    // Fonts stream glyphs from their source for as long as they live, so they skip the decoded cache,
+    // the archive mapping outlives every font
+    inline bool LoadResource(sf::Font& font, const std::string& path)
+    {
+        const void* data = nullptr;
+        size_t size = 0;
+        if (FindArchivedAsset(GetMountedAssetArchive(), GetArchivedAssetName(path), data, size))
+            return font.loadFromMemory(data, size);
+
+        return font.loadFromFile(path);
+    }
+
+    template <typename Resource>
+    bool LoadResource(Resource& resource, const std::string& path)
+    {
+        // Loose and archived copies of an asset share its decoded cache entry
+        const std::string assetName = GetArchivedAssetName(path);
+        const void* data = nullptr;
+        size_t size = 0;
+        if (FindArchivedAsset(GetMountedAssetArchive(), assetName, data, size))
+            return LoadDecodedResource(resource, assetName, data, size);
+
+        MappedFile file;
+        if (!OpenMappedFile(file, path))
+            return false;
+
+        const bool isLoaded = LoadDecodedResource(resource, assetName, file.data, file.size);
+        CloseMappedFile(file);
+        return isLoaded;
+    }
+
+    template <typename Resource>
+    std::shared_ptr<const Resource> AcquireResource(ResourceCache<Resource>& cache, const std::string& path)
+    {
+        {
+            std::lock_guard<std::mutex> lock(cache.mutex);
+            const auto cachedResource = cache.resources.find(path);
+            if (cachedResource != cache.resources.end())
+            {
+                if (std::shared_ptr<const Resource> resource = cachedResource->second.lock())
+                    return resource;
+            }
+        }
+
+        // Loaded without holding the lock, so loader threads decode different assets in parallel
+        const std::shared_ptr<Resource> resource = std::make_shared<Resource>();
+        if (!LoadResource(*resource, path))
+            return nullptr;
+
+        std::lock_guard<std::mutex> lock(cache.mutex);
+        std::weak_ptr<const Resource>& cachedResource = cache.resources[path];
+
+        // Another thread may have finished loading the same path first
+        if (std::shared_ptr<const Resource> loadedResource = cachedResource.lock())
+            return loadedResource;
+
+        cachedResource = resource;
+        ++cache.loadsCount;
+        return resource;
+    }
+
+    // Loads the path again even when it is cached, later acquires get the new version
+    template <typename Resource>
+    std::shared_ptr<const Resource> ReloadResource(ResourceCache<Resource>& cache, const std::string& path)
+    {
+        const std::shared_ptr<Resource> resource = std::make_shared<Resource>();
+        if (!LoadResource(*resource, path))
+            return nullptr;
+
+        std::lock_guard<std::mutex> lock(cache.mutex);
+        cache.resources[path] = resource;
+        ++cache.loadsCount;
+        return resource;
+    }
+
+    ResourceCache<sf::Font>& GetFontCache();
+    ResourceCache<sf::Image>& GetImageCache();
+    ResourceCache<sf::SoundBuffer>& GetSoundBufferCache();
+}
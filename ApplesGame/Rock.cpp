@@ -2,24 +2,26 @@
 #include "Constants.h"
 #include "Math.h"
 #include "Game.h"
+#include "JobSystem.h"
 
 namespace ApplesGame
 {
     void InitializeRocks(std::vector<Rock>& rocks, const Game& game)
     {
         rocks.resize(game.rocksAmount);
+        const bool isAppleOverlapAllowed = IsAppleOverlapAllowed(game);
 
         for (int i = 0; i < game.rocksAmount; ++i)
         {
             SetRandomColliderPosition(rocks[i].position, SCREEN_WIDTH, SCREEN_HEIGHT);
-            rocks[i].size.x = 20.0f;
-            rocks[i].size.y = 20.0f;
+            rocks[i].size.x = ROCK_SIZE;
+            rocks[i].size.y = ROCK_SIZE;
 
             bool isCollisionFree = true;
 
             for (const auto& apple : game.apples)
             {
-                if (CheckCircleAndRectangleCollision(apple, rocks[i]))
+                if (!isAppleOverlapAllowed && CheckCircleAndRectangleCollision(apple, rocks[i]))
                 {
                     isCollisionFree = false;
                     break;
@@ -38,27 +40,23 @@ namespace ApplesGame
                 }
             }
 
-            if (isCollisionFree)
-            {
-                SetRockPosition(rocks[i]);
-                rocks[i].sprite.setTexture(game.rockTexture);
-                SetSpriteSize(rocks[i].sprite, rocks[i].size.x, rocks[i].size.y);
-                SetSpriteRelativeOrigin(rocks[i].sprite, 0.5f, 0.5f);
-            }
-            else
-            {
+            if (!isCollisionFree)
                 --i;
-            }
         }
     }
 
-    void DrawRock(const Rock& rock, sf::RenderWindow& window)
+    void InitializeRocksBatch(SpriteBatch& batch, const std::vector<Rock>& rocks, const sf::IntRect& textureRect)
     {
-        window.draw(rock.sprite);
-    }
+        InitializeSpriteBatch(batch, rocks.size(), sf::VertexBuffer::Static);
 
-    void SetRockPosition(Rock& rock)
-    {
-        rock.sprite.setPosition(rock.position.x + rock.size.x / 2.f, rock.position.y + rock.size.y / 2.f);
+        // A freshly initialized batch is uploaded whole, so filling its quads never touches the shared dirty list
+        ParallelFor(GetJobSystem(), rocks.size(), SPRITE_QUAD_COST, [&batch, &rocks, &textureRect](const size_t begin, const size_t end)
+            {
+                for (size_t i = begin; i < end; ++i)
+                {
+                    SetSpriteBatchQuadBounds(batch, i, {rocks[i].position.x, rocks[i].position.y, rocks[i].size.x, rocks[i].size.y});
+                    SetSpriteBatchQuadTexture(batch, i, textureRect);
+                }
+            });
     }
 }
@@ -2,6 +2,7 @@
 #include <SFML/Graphics.hpp>
 #include <vector>
 #include "Math.h"
+#include "SpriteBatch.h"
 
 namespace ApplesGame
 {
@@ -9,10 +10,8 @@ namespace ApplesGame
 
     struct Rock : Rectangle
     {
-        sf::Sprite sprite;
     };
 
     void InitializeRocks(std::vector<Rock>& rocks, const Game& game);
-    void SetRockPosition(Rock& rock);
-    void DrawRock(const Rock& rock, sf::RenderWindow& window);
+    void InitializeRocksBatch(SpriteBatch& batch, const std::vector<Rock>& rocks, const sf::IntRect& textureRect);
 }
@@ -0,0 +1,312 @@
+#include <algorithm>
+#include <cmath>
+#include "SoftwareRenderer.h"
+#include "PixelBlending.h"
+#include "Renderer.h"
+
+namespace ApplesGame
+{
+    namespace
+    {
+        constexpr int GLYPH_WIDTH = 5;
+        constexpr int GLYPH_HEIGHT = 7;
+        constexpr char FIRST_GLYPH = ' ';
+        constexpr char LAST_GLYPH = '~';
+
+        // Printable ASCII, one byte per column, lowest bit is the top row
+        constexpr uint8_t GLYPHS[LAST_GLYPH - FIRST_GLYPH + 1][GLYPH_WIDTH] =
+        {
+            {0x00, 0x00, 0x00, 0x00, 0x00}, {0x00, 0x00, 0x5F, 0x00, 0x00}, {0x00, 0x07, 0x00, 0x07, 0x00},
+            {0x14, 0x7F, 0x14, 0x7F, 0x14}, {0x24, 0x2A, 0x7F, 0x2A, 0x12}, {0x23, 0x13, 0x08, 0x64, 0x62},
+            {0x36, 0x49, 0x55, 0x22, 0x50}, {0x00, 0x05, 0x03, 0x00, 0x00}, {0x00, 0x1C, 0x22, 0x41, 0x00},
+            {0x00, 0x41, 0x22, 0x1C, 0x00}, {0x08, 0x2A, 0x1C, 0x2A, 0x08}, {0x08, 0x08, 0x3E, 0x08, 0x08},
+            {0x00, 0x50, 0x30, 0x00, 0x00}, {0x08, 0x08, 0x08, 0x08, 0x08}, {0x00, 0x60, 0x60, 0x00, 0x00},
+            {0x20, 0x10, 0x08, 0x04, 0x02}, {0x3E, 0x51, 0x49, 0x45, 0x3E}, {0x00, 0x42, 0x7F, 0x40, 0x00},
+            {0x42, 0x61, 0x51, 0x49, 0x46}, {0x21, 0x41, 0x45, 0x4B, 0x31}, {0x18, 0x14, 0x12, 0x7F, 0x10},
+            {0x27, 0x45, 0x45, 0x45, 0x39}, {0x3C, 0x4A, 0x49, 0x49, 0x30}, {0x01, 0x71, 0x09, 0x05, 0x03},
+            {0x36, 0x49, 0x49, 0x49, 0x36}, {0x06, 0x49, 0x49, 0x29, 0x1E}, {0x00, 0x36, 0x36, 0x00, 0x00},
+            {0x00, 0x56, 0x36, 0x00, 0x00}, {0x08, 0x14, 0x22, 0x41, 0x00}, {0x14, 0x14, 0x14, 0x14, 0x14},
+            {0x00, 0x41, 0x22, 0x14, 0x08}, {0x02, 0x01, 0x51, 0x09, 0x06}, {0x32, 0x49, 0x79, 0x41, 0x3E},
+            {0x7E, 0x11, 0x11, 0x11, 0x7E}, {0x7F, 0x49, 0x49, 0x49, 0x36}, {0x3E, 0x41, 0x41, 0x41, 0x22},
+            {0x7F, 0x41, 0x41, 0x22, 0x1C}, {0x7F, 0x49, 0x49, 0x49, 0x41}, {0x7F, 0x09, 0x09, 0x09, 0x01},
+            {0x3E, 0x41, 0x49, 0x49, 0x7A}, {0x7F, 0x08, 0x08, 0x08, 0x7F}, {0x00, 0x41, 0x7F, 0x41, 0x00},
+            {0x20, 0x40, 0x41, 0x3F, 0x01}, {0x7F, 0x08, 0x14, 0x22, 0x41}, {0x7F, 0x40, 0x40, 0x40, 0x40},
+            {0x7F, 0x02, 0x0C, 0x02, 0x7F}, {0x7F, 0x04, 0x08, 0x10, 0x7F}, {0x3E, 0x41, 0x41, 0x41, 0x3E},
+            {0x7F, 0x09, 0x09, 0x09, 0x06}, {0x3E, 0x41, 0x51, 0x21, 0x5E}, {0x7F, 0x09, 0x19, 0x29, 0x46},
+            {0x46, 0x49, 0x49, 0x49, 0x31}, {0x01, 0x01, 0x7F, 0x01, 0x01}, {0x3F, 0x40, 0x40, 0x40, 0x3F},
+            {0x1F, 0x20, 0x40, 0x20, 0x1F}, {0x3F, 0x40, 0x38, 0x40, 0x3F}, {0x63, 0x14, 0x08, 0x14, 0x63},
+            {0x07, 0x08, 0x70, 0x08, 0x07}, {0x61, 0x51, 0x49, 0x45, 0x43}, {0x00, 0x7F, 0x41, 0x41, 0x00},
+            {0x02, 0x04, 0x08, 0x10, 0x20}, {0x00, 0x41, 0x41, 0x7F, 0x00}, {0x04, 0x02, 0x01, 0x02, 0x04},
+            {0x40, 0x40, 0x40, 0x40, 0x40}, {0x00, 0x01, 0x02, 0x04, 0x00}, {0x20, 0x54, 0x54, 0x54, 0x78},
+            {0x7F, 0x48, 0x44, 0x44, 0x38}, {0x38, 0x44, 0x44, 0x44, 0x20}, {0x38, 0x44, 0x44, 0x48, 0x7F},
+            {0x38, 0x54, 0x54, 0x54, 0x18}, {0x08, 0x7E, 0x09, 0x01, 0x02}, {0x0C, 0x52, 0x52, 0x52, 0x3E},
+            {0x7F, 0x08, 0x04, 0x04, 0x78}, {0x00, 0x44, 0x7D, 0x40, 0x00}, {0x20, 0x40, 0x44, 0x3D, 0x00},
+            {0x7F, 0x10, 0x28, 0x44, 0x00}, {0x00, 0x41, 0x7F, 0x40, 0x00}, {0x7C, 0x04, 0x18, 0x04, 0x78},
+            {0x7C, 0x08, 0x04, 0x04, 0x78}, {0x38, 0x44, 0x44, 0x44, 0x38}, {0x7C, 0x14, 0x14, 0x14, 0x08},
+            {0x08, 0x14, 0x14, 0x18, 0x7C}, {0x7C, 0x08, 0x04, 0x04, 0x08}, {0x48, 0x54, 0x54, 0x54, 0x20},
+            {0x04, 0x3F, 0x44, 0x40, 0x20}, {0x3C, 0x40, 0x40, 0x20, 0x7C}, {0x1C, 0x20, 0x40, 0x20, 0x1C},
+            {0x3C, 0x40, 0x30, 0x40, 0x3C}, {0x44, 0x28, 0x10, 0x28, 0x44}, {0x0C, 0x50, 0x50, 0x50, 0x3C},
+            {0x44, 0x64, 0x54, 0x4C, 0x44}, {0x00, 0x08, 0x36, 0x41, 0x00}, {0x00, 0x00, 0x7F, 0x00, 0x00},
+            {0x00, 0x41, 0x36, 0x08, 0x00}, {0x08, 0x04, 0x08, 0x10, 0x08}
+        };
+
+        void ClearFramebuffer(SoftwareFramebuffer& framebuffer, const sf::Color& color)
+        {
+            const uint8_t pixel[4] = {color.r, color.g, color.b, color.a};
+
+            for (size_t i = 0; i < framebuffer.pixels.size(); i += 4)
+                std::copy(pixel, pixel + 4, &framebuffer.pixels[i]);
+        }
+
+        uint8_t* GetFramebufferRow(SoftwareFramebuffer& framebuffer, const int y)
+        {
+            return &framebuffer.pixels[static_cast<size_t>(y) * framebuffer.width * 4];
+        }
+
+        // Fills every pixel whose center lies inside the transformed rectangle, sampling the atlas like an unsmoothed sf::Texture
+        void DrawTexturedQuad(SoftwareRenderer& renderer, const sf::Transform& transform, const sf::IntRect& textureRect)
+        {
+            SoftwareFramebuffer& framebuffer = renderer.framebuffer;
+            const float width = static_cast<float>(textureRect.width);
+            const float height = static_cast<float>(textureRect.height);
+
+            const sf::FloatRect bounds = transform.transformRect({0.f, 0.f, width, height});
+            const int left = std::max(0, static_cast<int>(std::floor(bounds.left)));
+            const int top = std::max(0, static_cast<int>(std::floor(bounds.top)));
+            const int right = std::min(static_cast<int>(framebuffer.width), static_cast<int>(std::ceil(bounds.left + bounds.width)));
+            const int bottom = std::min(static_cast<int>(framebuffer.height), static_cast<int>(std::ceil(bounds.top + bounds.height)));
+
+            // Texture coordinates change linearly across the screen, so each pixel is one step from its neighbour
+            const sf::Transform inverse = transform.getInverse();
+            const sf::Vector2f origin = inverse.transformPoint(0.f, 0.f);
+            const sf::Vector2f stepX = inverse.transformPoint(1.f, 0.f) - origin;
+            const sf::Vector2f stepY = inverse.transformPoint(0.f, 1.f) - origin;
+
+            const uint8_t* atlasPixels = renderer.atlasImage.image.getPixelsPtr();
+            const unsigned atlasWidth = renderer.atlasImage.image.getSize().x;
+            uint8_t* span = renderer.span.data();
+
+            for (int y = top; y < bottom; ++y)
+            {
+                uint8_t* row = GetFramebufferRow(framebuffer, y);
+                sf::Vector2f texel = origin + stepX * (static_cast<float>(left) + 0.5f) + stepY * (static_cast<float>(y) + 0.5f);
+                int spanStart = left;
+                size_t spanLength = 0;
+
+                for (int x = left; x < right; ++x, texel += stepX)
+                {
+                    if (texel.x >= 0.f && texel.x < width && texel.y >= 0.f && texel.y < height)
+                    {
+                        if (spanLength == 0)
+                            spanStart = x;
+
+                        const size_t texelIndex = (static_cast<size_t>(textureRect.top + static_cast<int>(texel.y)) * atlasWidth +
+                            textureRect.left + static_cast<int>(texel.x)) * 4;
+                        std::copy(atlasPixels + texelIndex, atlasPixels + texelIndex + 4, span + spanLength * 4);
+                        ++spanLength;
+                    }
+                    else if (spanLength > 0)
+                    {
+                        BlendPixelSpan(row + spanStart * 4, span, spanLength);
+                        spanLength = 0;
+                    }
+                }
+
+                if (spanLength > 0)
+                    BlendPixelSpan(row + spanStart * 4, span, spanLength);
+            }
+        }
+
+        void DrawTexturedRectangle(SoftwareRenderer& renderer, const sf::FloatRect& bounds, const sf::IntRect& textureRect)
+        {
+            sf::Transform transform;
+            transform.translate(bounds.left, bounds.top);
+            transform.scale(bounds.width / static_cast<float>(textureRect.width), bounds.height / static_cast<float>(textureRect.height));
+            DrawTexturedQuad(renderer, transform, textureRect);
+        }
+
+        void DrawParticles(SoftwareRenderer& renderer)
+        {
+            SoftwareFramebuffer& framebuffer = renderer.framebuffer;
+            const ParticlePool& particles = renderer.particles;
+            const int size = static_cast<int>(PARTICLE_SIZE);
+            const float halfSize = PARTICLE_SIZE / 2.f;
+            uint8_t* span = renderer.span.data();
+
+            for (size_t i = 0; i < particles.liveCount; ++i)
+            {
+                const int left = static_cast<int>(std::ceil(particles.positionsX[i] - halfSize - 0.5f));
+                const int top = static_cast<int>(std::ceil(particles.positionsY[i] - halfSize - 0.5f));
+                const int spanLeft = std::max(0, left);
+                const int spanRight = std::min(static_cast<int>(framebuffer.width), left + size);
+                if (spanLeft >= spanRight)
+                    continue;
+
+                const sf::Color& color = particles.colors[i];
+                const uint8_t pixel[4] = {color.r, color.g, color.b,
+                    static_cast<uint8_t>(255.f * GetParticleOpacity(particles, i))};
+                for (int x = spanLeft; x < spanRight; ++x)
+                    std::copy(pixel, pixel + 4, span + (x - spanLeft) * 4);
+
+                for (int y = std::max(0, top); y < std::min(static_cast<int>(framebuffer.height), top + size); ++y)
+                    BlendPixelSpan(GetFramebufferRow(framebuffer, y) + spanLeft * 4, span, spanRight - spanLeft);
+            }
+        }
+
+        // Built-in bitmap font scaled to the label size, sf::Font keeps its glyphs in GPU textures
+        void DrawLabel(SoftwareRenderer& renderer, const Label& label)
+        {
+            if (!label.isVisible)
+                return;
+
+            SoftwareFramebuffer& framebuffer = renderer.framebuffer;
+            const int scale = std::max(1, static_cast<int>(label.textSize) / GLYPH_HEIGHT);
+            const int advance = (GLYPH_WIDTH + 1) * scale;
+            const int lineHeight = static_cast<int>(label.textSize + label.textSize / 5);
+            const int glyphTop = (lineHeight - GLYPH_HEIGHT * scale) / 2;
+            const uint8_t color[4] = {label.color.r, label.color.g, label.color.b, label.color.a};
+            const uint8_t transparent[4] = {label.color.r, label.color.g, label.color.b, 0};
+            uint8_t* span = renderer.span.data();
+
+            const int left = static_cast<int>(std::lround(label.position.x));
+            int lineY = static_cast<int>(std::lround(label.position.y));
+            size_t lineStart = 0;
+
+            while (lineStart <= label.message.size())
+            {
+                size_t lineEnd = label.message.find('\n', lineStart);
+                if (lineEnd == std::string::npos)
+                    lineEnd = label.message.size();
+
+                const int lineLength = static_cast<int>(lineEnd - lineStart);
+                const int spanLeft = std::max(0, left);
+                const int spanRight = std::min(static_cast<int>(framebuffer.width), left + lineLength * advance);
+
+                for (int glyphY = 0; glyphY < GLYPH_HEIGHT * scale && spanLeft < spanRight; ++glyphY)
+                {
+                    const int y = lineY + glyphTop + glyphY;
+                    if (y < 0 || y >= static_cast<int>(framebuffer.height))
+                        continue;
+
+                    const int glyphRow = glyphY / scale;
+                    for (int x = spanLeft; x < spanRight; ++x)
+                    {
+                        const int offset = x - left;
+                        const int column = (offset % advance) / scale;
+                        char character = label.message[lineStart + offset / advance];
+                        if (character < FIRST_GLYPH || character > LAST_GLYPH)
+                            character = '?';
+
+                        const bool isSet = column < GLYPH_WIDTH && ((GLYPHS[character - FIRST_GLYPH][column] >> glyphRow) & 1);
+                        const uint8_t* pixel = isSet ? color : transparent;
+                        std::copy(pixel, pixel + 4, span + (x - spanLeft) * 4);
+                    }
+
+                    BlendPixelSpan(GetFramebufferRow(framebuffer, y) + spanLeft * 4, span, spanRight - spanLeft);
+                }
+
+                lineStart = lineEnd + 1;
+                lineY += lineHeight;
+            }
+        }
+
+        void SyncWorld(SoftwareRenderer& renderer, const RenderSnapshot& snapshot)
+        {
+            if (renderer.drawnLevelIndex == snapshot.levelIndex)
+                return;
+
+            InitializePlayerSprite(renderer.playerSprite, GetAtlasRegion(renderer.atlasImage.regions, PLAYER_TEXTURE_NAME),
+                snapshot.player.radius);
+            renderer.drawnLevelIndex = snapshot.levelIndex;
+        }
+    }
+
+    bool LoadSoftwareRendererResources(SoftwareRenderer& renderer)
+    {
+        return PackAtlasImage(renderer.atlasImage, ATLAS_TEXTURE_NAMES);
+    }
+
+    void InitializeSoftwareRenderer(SoftwareRenderer& renderer, const unsigned width, const unsigned height)
+    {
+        renderer.framebuffer.width = width;
+        renderer.framebuffer.height = height;
+        renderer.framebuffer.pixels.assign(static_cast<size_t>(width) * height * 4, 0);
+        renderer.span.resize(static_cast<size_t>(width) * 4);
+        renderer.drawnLevelIndex = -1;
+
+        InitializeUserInterface(renderer.ui);
+        InitializeParticlePool(renderer.particles, PARTICLES_CAPACITY);
+    }
+
+    void DrawSoftwareGame(SoftwareRenderer& renderer, const RenderSnapshot& snapshot)
+    {
+        UpdateScoreLabel(renderer.ui, snapshot.eatenApplesCount);
+        RotatePlayer(renderer.playerSprite, snapshot.playerDirection);
+
+        ClearFramebuffer(renderer.framebuffer, sf::Color::Black);
+
+        sf::Sprite& playerSprite = renderer.playerSprite.sprite;
+        playerSprite.setPosition(snapshot.player.position.x, snapshot.player.position.y);
+        DrawTexturedQuad(renderer, playerSprite.getTransform(), playerSprite.getTextureRect());
+
+        const sf::IntRect& appleRect = GetAtlasRegion(renderer.atlasImage.regions, APPLE_TEXTURE_NAME);
+        for (const Apple& apple : snapshot.apples)
+        {
+            if (!apple.isEaten)
+            {
+                DrawTexturedRectangle(renderer, {apple.position.x - apple.radius, apple.position.y - apple.radius,
+                    apple.radius * 2.f, apple.radius * 2.f}, appleRect);
+            }
+        }
+
+        const sf::IntRect& rockRect = GetAtlasRegion(renderer.atlasImage.regions, ROCK_TEXTURE_NAME);
+        for (const Rock& rock : snapshot.rocks)
+            DrawTexturedRectangle(renderer, {rock.position.x, rock.position.y, rock.size.x, rock.size.y}, rockRect);
+
+        DrawParticles(renderer);
+
+        DrawLabel(renderer, renderer.ui.scoreLabel);
+
+        if (snapshot.isHintVisible)
+            DrawLabel(renderer, renderer.ui.hintLabel);
+    }
+
+    void DrawSoftwareFrame(SoftwareRenderer& renderer, const RenderSnapshot& snapshot, const float deltaTime)
+    {
+        SyncWorld(renderer, snapshot);
+
+        for (const ParticleBurst& burst : snapshot.particleBursts)
+            EmitParticleBurst(renderer.particles, burst);
+        UpdateParticles(renderer.particles, deltaTime);
+
+        switch (snapshot.gameState)
+        {
+            case EGameState::MainMenu:
+                UpdateMenuLabels(renderer.ui, snapshot.mode);
+                ClearFramebuffer(renderer.framebuffer, sf::Color::Black);
+                for (const Label& menuLabel : renderer.ui.menuLabels)
+                    DrawLabel(renderer, menuLabel);
+                break;
+            case EGameState::Playing:
+                DrawSoftwareGame(renderer, snapshot);
+                break;
+            case EGameState::EndGame:
+            case EGameState::Scoreboard:
+                SetLabelMessage(renderer.ui.messageLabel, snapshot.message);
+                ClearFramebuffer(renderer.framebuffer, sf::Color::Black);
+                DrawLabel(renderer, renderer.ui.messageLabel);
+                if (snapshot.gameState == EGameState::EndGame)
+                    DrawParticles(renderer);
+                break;
+            default:
+                break;
+        }
+    }
+
+    bool SaveSoftwareFrame(const SoftwareRenderer& renderer, const std::string& filePath)
+    {
+        sf::Image image;
+        image.create(renderer.framebuffer.width, renderer.framebuffer.height, renderer.framebuffer.pixels.data());
+        return image.saveToFile(filePath);
+    }
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Particles.h"
+#include "Player.h"
+#include "TextureAtlas.h"
+#include "UI.h"
+
+namespace ApplesGame
+{
+    struct RenderSnapshot;
+
+    // 8-bit RGBA pixels, rows top to bottom, same layout as sf::Image
+    struct SoftwareFramebuffer
+    {
+        unsigned width = 0;
+        unsigned height = 0;
+        std::vector<uint8_t> pixels;
+    };
+
+    // Draws the same scene as Renderer into memory on the CPU, needs neither a GPU nor a display
+    struct SoftwareRenderer
+    {
+        SoftwareFramebuffer framebuffer;
+        AtlasImage atlasImage;
+        PlayerSprite playerSprite;
+        ParticlePool particles;
+        UserInterface ui;
+        int drawnLevelIndex = -1;
+
+        // Source pixels of the row being blended
+        std::vector<uint8_t> span;
+    };
+
+    bool LoadSoftwareRendererResources(SoftwareRenderer& renderer);
+    void InitializeSoftwareRenderer(SoftwareRenderer& renderer, unsigned width, unsigned height);
+    void DrawSoftwareGame(SoftwareRenderer& renderer, const RenderSnapshot& snapshot);
+    void DrawSoftwareFrame(SoftwareRenderer& renderer, const RenderSnapshot& snapshot, float deltaTime);
+    bool SaveSoftwareFrame(const SoftwareRenderer& renderer, const std::string& filePath);
+}
@@ -0,0 +1,80 @@
+#include "SpriteBatch.h"
+
+namespace ApplesGame
+{
+    namespace
+    {
+        void MarkQuadDirty(SpriteBatch& batch, const size_t index)
+        {
+            if (!batch.isFullUploadRequired)
+                batch.dirtyQuads.push_back(index);
+        }
+
+        void UploadDirtyQuads(SpriteBatch& batch)
+        {
+            if (batch.isFullUploadRequired)
+            {
+                if (batch.vertices.getVertexCount() > 0)
+                    batch.buffer.update(&batch.vertices[0]);
+            }
+            else
+            {
+                for (const size_t index : batch.dirtyQuads)
+                    batch.buffer.update(&batch.vertices[index * 4], 4, static_cast<unsigned>(index * 4));
+            }
+
+            batch.dirtyQuads.clear();
+            batch.isFullUploadRequired = false;
+        }
+    }
+
+    void InitializeSpriteBatch(SpriteBatch& batch, const size_t quadsCount, const sf::VertexBuffer::Usage usage)
+    {
+        batch.vertices.setPrimitiveType(sf::Quads);
+        batch.vertices.resize(quadsCount * 4);
+
+        batch.buffer.setPrimitiveType(sf::Quads);
+        batch.buffer.setUsage(usage);
+        batch.isGpuResident = sf::VertexBuffer::isAvailable() && batch.buffer.create(quadsCount * 4);
+
+        batch.dirtyQuads.clear();
+        batch.isFullUploadRequired = true;
+    }
+
+    void SetSpriteBatchQuadBounds(SpriteBatch& batch, const size_t index, const sf::FloatRect& bounds)
+    {
+        sf::Vertex* quad = &batch.vertices[index * 4];
+        quad[0].position = {bounds.left, bounds.top};
+        quad[1].position = {bounds.left + bounds.width, bounds.top};
+        quad[2].position = {bounds.left + bounds.width, bounds.top + bounds.height};
+        quad[3].position = {bounds.left, bounds.top + bounds.height};
+        MarkQuadDirty(batch, index);
+    }
+
+    void SetSpriteBatchQuadTexture(SpriteBatch& batch, const size_t index, const sf::IntRect& textureRect)
+    {
+        const float left = static_cast<float>(textureRect.left);
+        const float top = static_cast<float>(textureRect.top);
+        const float right = static_cast<float>(textureRect.left + textureRect.width);
+        const float bottom = static_cast<float>(textureRect.top + textureRect.height);
+
+        sf::Vertex* quad = &batch.vertices[index * 4];
+        quad[0].texCoords = {left, top};
+        quad[1].texCoords = {right, top};
+        quad[2].texCoords = {right, bottom};
+        quad[3].texCoords = {left, bottom};
+        MarkQuadDirty(batch, index);
+    }
+
+    void DrawSpriteBatch(SpriteBatch& batch, const sf::Texture& texture, RenderQueue& queue)
+    {
+        if (!batch.isGpuResident)
+        {
+            PushDrawable(queue, ERenderLayer::World, batch.vertices, &texture);
+            return;
+        }
+
+        UploadDirtyQuads(batch);
+        PushDrawable(queue, ERenderLayer::World, batch.buffer, &texture);
+    }
+}
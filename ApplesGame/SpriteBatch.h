@@ -0,0 +1,25 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <vector>
+#include "RenderQueue.h"
+
+namespace ApplesGame
+{
+    // Textured quads kept on the GPU between frames, only quads changed since the last draw are uploaded
+    struct SpriteBatch
+    {
+        sf::VertexArray vertices;
+        sf::VertexBuffer buffer;
+        std::vector<size_t> dirtyQuads;
+        bool isGpuResident = false;
+        bool isFullUploadRequired = false;
+    };
+
+    // Estimated nanoseconds to fill one quad, for splitting large batches across the job system
+    constexpr float SPRITE_QUAD_COST = 10.f;
+
+    void InitializeSpriteBatch(SpriteBatch& batch, size_t quadsCount, sf::VertexBuffer::Usage usage);
+    void SetSpriteBatchQuadBounds(SpriteBatch& batch, size_t index, const sf::FloatRect& bounds);
+    void SetSpriteBatchQuadTexture(SpriteBatch& batch, size_t index, const sf::IntRect& textureRect);
+    void DrawSpriteBatch(SpriteBatch& batch, const sf::Texture& texture, RenderQueue& queue);
+}
@@ -0,0 +1,50 @@
+#include <SFML/System/Clock.hpp>
+#include <iomanip>
+#include "StartupProfile.h"
+
+namespace ApplesGame
+{
+    namespace
+    {
+        // Started during static initialization, so the profile also covers the time before main
+        const sf::Clock processClock;
+    }
+
+    sf::Time GetTimeSinceProcessStart()
+    {
+        return processClock.getElapsedTime();
+    }
+
+    void MarkStartupPhase(StartupProfile& profile, const std::string& name, const sf::Time end)
+    {
+        profile.phases.push_back({name, end});
+    }
+
+    sf::Time GetStartupTime(const StartupProfile& profile)
+    {
+        return profile.phases.empty() ? sf::Time::Zero : profile.phases.back().end;
+    }
+
+    bool IsStartupOverBudget(const StartupProfile& profile, const sf::Time budget)
+    {
+        return profile.phases.empty() || GetStartupTime(profile) > budget;
+    }
+
+    void PrintStartupProfile(const StartupProfile& profile, std::ostream& stream)
+    {
+        const std::ios::fmtflags flags = stream.flags();
+        stream << "Startup, ms:" << std::fixed << std::setprecision(1) << std::endl;
+
+        sf::Time start = sf::Time::Zero;
+        for (const StartupPhase& phase : profile.phases)
+        {
+            stream << "  " << std::left << std::setw(24) << phase.name << std::right << std::setw(8)
+                << (phase.end - start).asMicroseconds() / 1000.f << std::endl;
+            start = phase.end;
+        }
+
+        stream << "  " << std::left << std::setw(24) << "Total" << std::right << std::setw(8)
+            << GetStartupTime(profile).asMicroseconds() / 1000.f << std::endl;
+        stream.flags(flags);
+    }
+}
@@ -0,0 +1,27 @@
+#pragma once
+#include <SFML/System/Time.hpp>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace ApplesGame
+{
+    struct StartupPhase
+    {
+        std::string name;
+        sf::Time end;
+    };
+
+    // Phases in the order they finished, each one lasts from the end of the previous one
+    struct StartupProfile
+    {
+        std::vector<StartupPhase> phases;
+    };
+
+    sf::Time GetTimeSinceProcessStart();
+    void MarkStartupPhase(StartupProfile& profile, const std::string& name, sf::Time end = GetTimeSinceProcessStart());
+    sf::Time GetStartupTime(const StartupProfile& profile);
+    // A profile without phases measured nothing, so it never passes as within the budget
+    bool IsStartupOverBudget(const StartupProfile& profile, sf::Time budget);
+    void PrintStartupProfile(const StartupProfile& profile, std::ostream& stream);
+}
@@ -0,0 +1,292 @@
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <iomanip>
+#include <memory>
+#include "TextureAtlas.h"
+#include "Constants.h"
+#include "ResourceCache.h"
+
+namespace ApplesGame
+{
+    namespace
+    {
+        // Transparent gap between packed images, regions also start on multiples of it,
+        // so the first mip levels never average neighbouring images together
+        constexpr unsigned ATLAS_PADDING = 4;
+
+        struct ResampleTap
+        {
+            unsigned first = 0;
+            std::vector<float> weights;
+        };
+
+        unsigned GetNextPowerOfTwo(const unsigned value)
+        {
+            unsigned result = 1;
+            while (result < value)
+                result *= 2;
+
+            return result;
+        }
+
+        unsigned AlignToPadding(const unsigned value)
+        {
+            return (value + ATLAS_PADDING - 1) / ATLAS_PADDING * ATLAS_PADDING;
+        }
+
+        // Each target pixel averages the source pixels it covers, weighted by how much of them it covers
+        std::vector<ResampleTap> GetResampleTaps(const unsigned sourceSize, const unsigned targetSize)
+        {
+            std::vector<ResampleTap> taps(targetSize);
+            const float scale = static_cast<float>(sourceSize) / static_cast<float>(targetSize);
+
+            for (unsigned i = 0; i < targetSize; ++i)
+            {
+                const float start = static_cast<float>(i) * scale;
+                const float end = std::min(start + scale, static_cast<float>(sourceSize));
+                ResampleTap& tap = taps[i];
+                tap.first = static_cast<unsigned>(start);
+
+                for (unsigned source = tap.first; static_cast<float>(source) < end; ++source)
+                {
+                    const float coverage = std::min(end, source + 1.f) - std::max(start, static_cast<float>(source));
+                    tap.weights.push_back(coverage / scale);
+                }
+            }
+
+            return taps;
+        }
+
+        // Box filter in premultiplied alpha, so transparent pixels do not darken the edges of a sprite
+        void ResampleImage(const sf::Image& source, const sf::Vector2u& targetSize, sf::Image& target)
+        {
+            const sf::Vector2u sourceSize = source.getSize();
+            const std::vector<ResampleTap> columnTaps = GetResampleTaps(sourceSize.x, targetSize.x);
+            const std::vector<ResampleTap> rowTaps = GetResampleTaps(sourceSize.y, targetSize.y);
+            const sf::Uint8* sourcePixels = source.getPixelsPtr();
+
+            // Rows are resampled first, then the columns of the narrowed image
+            std::vector<float> narrowed(static_cast<size_t>(targetSize.x) * sourceSize.y * 4, 0.f);
+            for (unsigned y = 0; y < sourceSize.y; ++y)
+            {
+                for (unsigned x = 0; x < targetSize.x; ++x)
+                {
+                    float* pixel = &narrowed[(static_cast<size_t>(y) * targetSize.x + x) * 4];
+                    const ResampleTap& tap = columnTaps[x];
+
+                    for (size_t i = 0; i < tap.weights.size(); ++i)
+                    {
+                        const sf::Uint8* sourcePixel = &sourcePixels[(static_cast<size_t>(y) * sourceSize.x + tap.first + i) * 4];
+                        const float weight = tap.weights[i] * sourcePixel[3] / 255.f;
+                        pixel[0] += sourcePixel[0] * weight;
+                        pixel[1] += sourcePixel[1] * weight;
+                        pixel[2] += sourcePixel[2] * weight;
+                        pixel[3] += sourcePixel[3] * tap.weights[i];
+                    }
+                }
+            }
+
+            std::vector<sf::Uint8> pixels(static_cast<size_t>(targetSize.x) * targetSize.y * 4);
+            for (unsigned y = 0; y < targetSize.y; ++y)
+            {
+                const ResampleTap& tap = rowTaps[y];
+                for (unsigned x = 0; x < targetSize.x; ++x)
+                {
+                    float sum[4] = {0.f, 0.f, 0.f, 0.f};
+                    for (size_t i = 0; i < tap.weights.size(); ++i)
+                    {
+                        const float* narrowedPixel = &narrowed[((tap.first + i) * targetSize.x + x) * 4];
+                        for (int channel = 0; channel < 4; ++channel)
+                            sum[channel] += narrowedPixel[channel] * tap.weights[i];
+                    }
+
+                    sf::Uint8* pixel = &pixels[(static_cast<size_t>(y) * targetSize.x + x) * 4];
+                    const float alpha = sum[3] / 255.f;
+                    for (int channel = 0; channel < 3; ++channel)
+                        pixel[channel] = alpha > 0.f ? static_cast<sf::Uint8>(std::min(255.f, sum[channel] / alpha + 0.5f)) : 0;
+                    pixel[3] = static_cast<sf::Uint8>(std::min(255.f, sum[3] + 0.5f));
+                }
+            }
+
+            target.create(targetSize.x, targetSize.y, pixels.data());
+        }
+
+        // Sources larger than their largest on-screen size are resampled down to it
+        std::shared_ptr<const sf::Image> LoadAtlasImage(const std::string& fileName, sf::Vector2u& sourceSize)
+        {
+            std::shared_ptr<const sf::Image> image = AcquireResource(GetImageCache(), RESOURCES_PATH + fileName);
+            if (!image)
+                return nullptr;
+
+            sourceSize = image->getSize();
+            const auto drawnSize = ATLAS_TEXTURE_SIZES.find(fileName);
+            if (drawnSize == ATLAS_TEXTURE_SIZES.end())
+                return image;
+
+            const sf::Vector2u targetSize(std::min(sourceSize.x, drawnSize->second), std::min(sourceSize.y, drawnSize->second));
+            if (targetSize == sourceSize)
+                return image;
+
+            const std::shared_ptr<sf::Image> resampledImage = std::make_shared<sf::Image>();
+            ResampleImage(*image, targetSize, *resampledImage);
+            return resampledImage;
+        }
+
+        bool UploadAtlasImage(TextureAtlas& atlas, const AtlasImage& atlasImage)
+        {
+            if (!atlas.texture.loadFromImage(atlasImage.image))
+                return false;
+
+            atlas.regions = atlasImage.regions;
+            atlas.sourceSizes = atlasImage.sourceSizes;
+
+            // Only used while the world is rendered below native resolution, without it minified sprites shimmer
+            atlas.texture.generateMipmap();
+            return true;
+        }
+    }
+
+    bool PackAtlasImage(AtlasImage& atlasImage, const std::vector<std::string>& fileNames)
+    {
+        std::vector<std::shared_ptr<const sf::Image>> images(fileNames.size());
+        std::vector<size_t> order(fileNames.size());
+        unsigned totalArea = 0;
+        unsigned maxWidth = 0;
+
+        atlasImage.sourceSizes.clear();
+        for (size_t i = 0; i < fileNames.size(); ++i)
+        {
+            images[i] = LoadAtlasImage(fileNames[i], atlasImage.sourceSizes[fileNames[i]]);
+            if (!images[i])
+                return false;
+
+            const sf::Vector2u size = images[i]->getSize();
+            totalArea += AlignToPadding(size.x + ATLAS_PADDING) * AlignToPadding(size.y + ATLAS_PADDING);
+            maxWidth = std::max(maxWidth, AlignToPadding(size.x) + 2 * ATLAS_PADDING);
+            order[i] = i;
+        }
+        // Shelf packing: tallest images first, each row of the atlas is as high as its first image
+        std::sort(order.begin(), order.end(), [&images](const size_t a, const size_t b)
+            {
+                return images[a]->getSize().y > images[b]->getSize().y;
+            });
+
+        const unsigned atlasWidth = GetNextPowerOfTwo(
+            std::max(maxWidth, static_cast<unsigned>(std::ceil(std::sqrt(static_cast<float>(totalArea))))));
+
+        atlasImage.regions.clear();
+        unsigned x = ATLAS_PADDING;
+        unsigned y = ATLAS_PADDING;
+        unsigned shelfHeight = 0;
+
+        for (const size_t index : order)
+        {
+            const sf::Vector2u size = images[index]->getSize();
+
+            if (x + size.x + ATLAS_PADDING > atlasWidth)
+            {
+                x = ATLAS_PADDING;
+                y = AlignToPadding(y + shelfHeight + ATLAS_PADDING);
+                shelfHeight = 0;
+            }
+
+            atlasImage.regions[fileNames[index]] = sf::IntRect(x, y, size.x, size.y);
+            x = AlignToPadding(x + size.x + ATLAS_PADDING);
+            shelfHeight = std::max(shelfHeight, size.y);
+        }
+
+        atlasImage.image.create(atlasWidth, y + shelfHeight + ATLAS_PADDING, sf::Color::Transparent);
+
+        for (size_t i = 0; i < fileNames.size(); ++i)
+        {
+            const sf::IntRect& region = atlasImage.regions[fileNames[i]];
+            atlasImage.image.copy(*images[i], region.left, region.top);
+        }
+
+        return true;
+    }
+
+    bool BuildTextureAtlas(TextureAtlas& atlas, const std::vector<std::string>& fileNames)
+    {
+        AtlasImage atlasImage;
+        if (!PackAtlasImage(atlasImage, fileNames))
+            return false;
+
+        return UploadAtlasImage(atlas, atlasImage);
+    }
+
+    // Changed images that keep their size are uploaded over their own region, anything else repacks the whole atlas
+    bool UpdateTextureAtlas(TextureAtlas& atlas, const std::vector<std::string>& fileNames,
+                            const std::vector<std::string>& changedFileNames, bool& isRepacked)
+    {
+        isRepacked = false;
+
+        // Every changed image is loaded and checked before the atlas is touched, so a failed load,
+        // such as a half-written file, leaves the atlas as it was
+        std::vector<std::shared_ptr<const sf::Image>> images(changedFileNames.size());
+        std::vector<sf::Vector2u> sourceSizes(changedFileNames.size());
+        for (size_t i = 0; i < changedFileNames.size(); ++i)
+        {
+            images[i] = LoadAtlasImage(changedFileNames[i], sourceSizes[i]);
+            if (!images[i])
+                return false;
+
+            const auto region = atlas.regions.find(changedFileNames[i]);
+            isRepacked |= region == atlas.regions.end() || atlas.sourceSizes.count(changedFileNames[i]) == 0 ||
+                images[i]->getSize() != sf::Vector2u(region->second.width, region->second.height);
+        }
+
+        if (!isRepacked)
+        {
+            for (size_t i = 0; i < changedFileNames.size(); ++i)
+            {
+                const sf::IntRect& region = atlas.regions[changedFileNames[i]];
+                atlas.texture.update(*images[i], region.left, region.top);
+                atlas.sourceSizes[changedFileNames[i]] = sourceSizes[i];
+            }
+
+            atlas.texture.generateMipmap();
+            return true;
+        }
+
+        // Built aside, so a failed repack leaves the current atlas intact
+        TextureAtlas repackedAtlas;
+        if (!BuildTextureAtlas(repackedAtlas, fileNames))
+            return false;
+
+        atlas.texture.swap(repackedAtlas.texture);
+        atlas.regions = std::move(repackedAtlas.regions);
+        atlas.sourceSizes = std::move(repackedAtlas.sourceSizes);
+        return true;
+    }
+
+    void PrintTextureAtlasMemory(const TextureAtlas& atlas, std::ostream& stream)
+    {
+        const std::ios::fmtflags flags = stream.flags();
+        stream << "Texture memory, KiB:" << std::fixed << std::setprecision(1) << std::endl;
+
+        for (const auto& region : atlas.regions)
+        {
+            const sf::Vector2u& sourceSize = atlas.sourceSizes.at(region.first);
+            stream << "  " << std::left << std::setw(16) << region.first << std::right
+                << std::setw(4) << region.second.width << "x" << std::left << std::setw(4) << region.second.height << std::right
+                << std::setw(8) << region.second.width * region.second.height * 4 / 1024.f
+                << "  (source " << sourceSize.x << "x" << sourceSize.y << ", "
+                << sourceSize.x * sourceSize.y * 4 / 1024.f << ")" << std::endl;
+        }
+
+        // A full mip chain adds a third on top of the base level
+        const sf::Vector2u atlasSize = atlas.texture.getSize();
+        stream << "  Atlas " << atlasSize.x << "x" << atlasSize.y << " with mipmaps: "
+            << atlasSize.x * atlasSize.y * 4 * 4 / 3 / 1024.f << std::endl;
+        stream.flags(flags);
+    }
+
+    const sf::IntRect& GetAtlasRegion(const AtlasRegions& regions, const std::string& fileName)
+    {
+        const auto region = regions.find(fileName);
+        assert(region != regions.end());
+        return region->second;
+    }
+}
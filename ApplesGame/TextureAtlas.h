@@ -0,0 +1,35 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ApplesGame
+{
+    typedef std::unordered_map<std::string, sf::IntRect> AtlasRegions;
+    typedef std::unordered_map<std::string, sf::Vector2u> AtlasSourceSizes;
+
+    // Packed pixels on the CPU side, usable without an OpenGL context
+    struct AtlasImage
+    {
+        sf::Image image;
+        AtlasRegions regions;
+        AtlasSourceSizes sourceSizes;
+    };
+
+    // All sprite images packed into one texture, so sprites of different kinds can share a draw call
+    struct TextureAtlas
+    {
+        sf::Texture texture;
+        AtlasRegions regions;
+        AtlasSourceSizes sourceSizes;
+    };
+
+    bool PackAtlasImage(AtlasImage& atlasImage, const std::vector<std::string>& fileNames);
+    bool BuildTextureAtlas(TextureAtlas& atlas, const std::vector<std::string>& fileNames);
+    bool UpdateTextureAtlas(TextureAtlas& atlas, const std::vector<std::string>& fileNames,
+                            const std::vector<std::string>& changedFileNames, bool& isRepacked);
+    void PrintTextureAtlasMemory(const TextureAtlas& atlas, std::ostream& stream);
+    const sf::IntRect& GetAtlasRegion(const AtlasRegions& regions, const std::string& fileName);
+}
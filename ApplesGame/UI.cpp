@@ -1,61 +1,160 @@
 ﻿#include "UI.h"
 #include "Constants.h"
-#include "Game.h"
+#include "ResourceCache.h"
 #include <cassert>
 
 namespace ApplesGame
 {
     void InitializeLabel(Label& label)
     {
-        assert(label.textFont.loadFromFile(RESOURCES_PATH + FONT_NAME));
-
-        label.text.setFont(label.textFont);
+        SetLabelFont(label, AcquireResource(GetFontCache(), RESOURCES_PATH + FONT_NAME));
         label.text.setCharacterSize(label.textSize);
         label.text.setString(label.message);
         label.text.setPosition(label.position.x, label.position.y);
         label.text.setFillColor(label.color);
     }
 
-    void ShowMenu(Game& game, sf::RenderWindow& window)
+    void SetLabelFont(Label& label, const std::shared_ptr<const sf::Font>& font)
     {
-        window.clear();
+        assert(font);
+        label.textFont = font;
+        label.text.setFont(*label.textFont);
+    }
+
+    void SetUserInterfaceFont(UserInterface& ui, const std::shared_ptr<const sf::Font>& font)
+    {
+        for (Label& menuLabel : ui.menuLabels)
+            SetLabelFont(menuLabel, font);
+
+        SetLabelFont(ui.scoreLabel, font);
+        SetLabelFont(ui.hintLabel, font);
+        SetLabelFont(ui.messageLabel, font);
+    }
+
+    void SetLabelMessage(Label& label, const std::string& message)
+    {
+        // Converting to sf::String and rebuilding glyph geometry is only worth it for a new message
+        if (label.message == message)
+            return;
+
+        label.message = message;
+        label.text.setString(label.message);
+    }
+
+    void SetLabelColor(Label& label, const sf::Color& color)
+    {
+        if (label.color == color)
+            return;
+
+        label.color = color;
+        label.text.setFillColor(label.color);
+    }
+
+    void DrawLabel(Label& label, RenderQueue& queue)
+    {
+        if (label.isVisible)
+            PushDrawable(queue, ERenderLayer::Interface, label.text, &label.textFont->getTexture(label.textSize));
+    }
+
+    void ShowMenu(UserInterface& ui, const uint8_t mode, RenderQueue& queue)
+    {
+        UpdateMenuLabels(ui, mode);
 
-        for (auto& menuLabel : game.menuLabels)
-            window.draw(menuLabel.text);
+        for (auto& menuLabel : ui.menuLabels)
+            DrawLabel(menuLabel, queue);
     }
 
-    void InitializeMenu(Game& game)
+    void InitializeMenu(UserInterface& ui)
     {
-        game.menuLabels[static_cast<int>(EMenuOptions::FiniteMode)].message = "1. Finite game mode";
-        game.menuLabels[static_cast<int>(EMenuOptions::FiniteMode)].color = sf::Color::Green;
+        ui.menuLabels[static_cast<int>(EMenuOptions::FiniteMode)].message = "1. Finite game mode";
+        ui.menuLabels[static_cast<int>(EMenuOptions::FiniteMode)].color = sf::Color::Green;
 
-        game.menuLabels[static_cast<int>(EMenuOptions::EndlessMode)].message = "2. Endless game mode";
-        game.menuLabels[static_cast<int>(EMenuOptions::EndlessMode)].color = sf::Color::Yellow;
+        ui.menuLabels[static_cast<int>(EMenuOptions::EndlessMode)].message = "2. Endless game mode";
+        ui.menuLabels[static_cast<int>(EMenuOptions::EndlessMode)].color = sf::Color::Yellow;
 
-        game.menuLabels[static_cast<int>(EMenuOptions::AccelerationMode)].message = "3. Acceleration game mode";
-        game.menuLabels[static_cast<int>(EMenuOptions::AccelerationMode)].color = sf::Color::Green;
+        ui.menuLabels[static_cast<int>(EMenuOptions::AccelerationMode)].message = "3. Acceleration game mode";
+        ui.menuLabels[static_cast<int>(EMenuOptions::AccelerationMode)].color = sf::Color::Green;
 
-        game.menuLabels[static_cast<int>(EMenuOptions::StandardSpeedMode)].message = "4. Standard speed game mode";
-        game.menuLabels[static_cast<int>(EMenuOptions::StandardSpeedMode)].color = sf::Color::Yellow;
+        ui.menuLabels[static_cast<int>(EMenuOptions::StandardSpeedMode)].message = "4. Standard speed game mode";
+        ui.menuLabels[static_cast<int>(EMenuOptions::StandardSpeedMode)].color = sf::Color::Yellow;
 
-        game.menuLabels[static_cast<int>(EMenuOptions::Scoreboard)].message = "5. Show scoreboard";
-        game.menuLabels[static_cast<int>(EMenuOptions::Scoreboard)].color = sf::Color::Yellow;
+        ui.menuLabels[static_cast<int>(EMenuOptions::Scoreboard)].message = "5. Show scoreboard";
+        ui.menuLabels[static_cast<int>(EMenuOptions::Scoreboard)].color = sf::Color::Yellow;
 
-        game.menuLabels[static_cast<int>(EMenuOptions::StartGame)].message = "Enter - Start game";
-        game.menuLabels[static_cast<int>(EMenuOptions::StartGame)].color = sf::Color::Cyan;
+        ui.menuLabels[static_cast<int>(EMenuOptions::StartGame)].message = "Enter - Start game";
+        ui.menuLabels[static_cast<int>(EMenuOptions::StartGame)].color = sf::Color::Cyan;
 
         for (size_t i = 0; i < static_cast<int>(EMenuOptions::None); ++i)
         {
-            game.menuLabels[i].position = {10.0f, (static_cast<float>(i) + 1) * 15.0f};
-            InitializeLabel(game.menuLabels[i]);
+            ui.menuLabels[i].position = {10.0f, (static_cast<float>(i) + 1) * 15.0f};
+            InitializeLabel(ui.menuLabels[i]);
         }
     }
+
+    void InitializeUserInterface(UserInterface& ui)
+    {
+        InitializeMenu(ui);
+
+        ui.scoreLabel.position = { 10, 10 };
+        InitializeLabel(ui.scoreLabel);
+
+        ui.hintLabel.position = { 10, 30 };
+        ui.hintLabel.message = "Use arrows to move pacman.\nEat apples, dont touch borders and rocks."
+            "\nFor toggle sound press \"M\" key"
+            "\nFor toggle hint message visibility press \"H\" key";
+        InitializeLabel(ui.hintLabel);
+
+        ui.messageLabel.position = { 10, 10 };
+        InitializeLabel(ui.messageLabel);
+
+        ui.shownScore = -1;
+    }
+
+    void UpdateMenuLabels(UserInterface& ui, const uint8_t mode)
+    {
+        SetLabelColor(ui.menuLabels[static_cast<int>(EMenuOptions::FiniteMode)],
+            (mode & FINITE_MODE) ? sf::Color::Green : sf::Color::Yellow);
+        SetLabelColor(ui.menuLabels[static_cast<int>(EMenuOptions::EndlessMode)],
+            (mode & ENDLESS_MODE) ? sf::Color::Green : sf::Color::Yellow);
+        SetLabelColor(ui.menuLabels[static_cast<int>(EMenuOptions::AccelerationMode)],
+            (mode & ACCELERATION_MODE) ? sf::Color::Green : sf::Color::Yellow);
+        SetLabelColor(ui.menuLabels[static_cast<int>(EMenuOptions::StandardSpeedMode)],
+            (mode & NO_ACCELERATION_MODE) ? sf::Color::Green : sf::Color::Yellow);
+    }
+
+    void UpdateScoreLabel(UserInterface& ui, const int eatenApplesCount)
+    {
+        if (ui.shownScore == eatenApplesCount)
+            return;
+
+        SetLabelMessage(ui.scoreLabel, "Score: " + std::to_string(eatenApplesCount));
+        ui.shownScore = eatenApplesCount;
+    }
     
-    void DisplayMessage(Game& game, const std::string& message, sf::RenderWindow& window)
+    void DisplayMessage(UserInterface& ui, const std::string& message, RenderQueue& queue)
+    {
+        SetLabelMessage(ui.messageLabel, message);
+        DrawLabel(ui.messageLabel, queue);
+    }
+
+    void DrawLoadingScreen(sf::RenderWindow& window, const float progress)
     {
-        game.scoreLabel.text.setString(message);
+        // Plain shapes only, the font may still be loading
+        const sf::Vector2f barSize = {SCREEN_WIDTH / 2.f, 12.f};
+        const sf::Vector2f barPosition = {(SCREEN_WIDTH - barSize.x) / 2.f, (SCREEN_HEIGHT - barSize.y) / 2.f};
+
+        sf::RectangleShape frame(barSize);
+        frame.setPosition(barPosition);
+        frame.setFillColor(sf::Color::Transparent);
+        frame.setOutlineColor(sf::Color::Cyan);
+        frame.setOutlineThickness(1.f);
+
+        sf::RectangleShape bar({barSize.x * progress, barSize.y});
+        bar.setPosition(barPosition);
+        bar.setFillColor(sf::Color::Cyan);
+
         window.clear();
-        window.draw(game.scoreLabel.text);
-        window.display();
+        window.draw(frame);
+        window.draw(bar);
     }
-}
+}
\ No newline at end of file
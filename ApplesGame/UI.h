@@ -1,27 +1,47 @@
 ﻿#pragma once
 #include "Math.h"
+#include "Game.h"
+#include "RenderQueue.h"
 #include <SFML/Graphics.hpp>
+#include <memory>
 #include <string>
 
 namespace ApplesGame
 {
-    struct Game;
-    
     struct Label
     {
         bool isVisible = true;
         Position2D position;
         std::string message;
         sf::Text text;
-        sf::Font textFont;
+        std::shared_ptr<const sf::Font> textFont;
         sf::Color color = sf::Color::Cyan;
         unsigned textSize = 15;
     };
 
+    // Labels of every screen, shared by the window and the software backends
+    struct UserInterface
+    {
+        Label menuLabels[static_cast<int>(EMenuOptions::None)];
+        Label scoreLabel;
+        Label hintLabel;
+        Label messageLabel;
+        int shownScore = -1;
+    };
+
     void InitializeLabel(Label& label);
-    void ShowMenu(Game& game, sf::RenderWindow& window);
-    void InitializeMenu(Game& game);
-    void DisplayMessage(Game& game, const std::string& message, sf::RenderWindow& window);
+    void SetLabelFont(Label& label, const std::shared_ptr<const sf::Font>& font);
+    void SetUserInterfaceFont(UserInterface& ui, const std::shared_ptr<const sf::Font>& font);
+    void SetLabelMessage(Label& label, const std::string& message);
+    void SetLabelColor(Label& label, const sf::Color& color);
+    void DrawLabel(Label& label, RenderQueue& queue);
+    void ShowMenu(UserInterface& ui, uint8_t mode, RenderQueue& queue);
+    void InitializeMenu(UserInterface& ui);
+    void InitializeUserInterface(UserInterface& ui);
+    void UpdateMenuLabels(UserInterface& ui, uint8_t mode);
+    void UpdateScoreLabel(UserInterface& ui, int eatenApplesCount);
+    void DisplayMessage(UserInterface& ui, const std::string& message, RenderQueue& queue);
+    void DrawLoadingScreen(sf::RenderWindow& window, float progress);
 
     
 }
@@ -3,65 +3,329 @@
 
 #include <SFML/Graphics.hpp>
 #include <SFML/Audio.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include "AssetArchive.h"
+#include "AssetLoader.h"
+#include "AssetWatcher.h"
 #include "Constants.h"
+#include "DecodedAssetCache.h"
+#include "FramePacer.h"
 #include "Game.h"
+#include "Input.h"
+#include "Renderer.h"
+#include "ResourceCache.h"
+#include "SoftwareRenderer.h"
+#include "StartupProfile.h"
 
 using namespace ApplesGame;
 
-int main()
+// Average time of one particle update, the stress load of --particles is measured with it
+void PrintParticleUpdateTime(const ParticlePool& particles)
 {
-	sf::RenderWindow window(sf::VideoMode(SCREEN_WIDTH, SCREEN_HEIGHT), GAME_TITLE);
+	if (particles.updatesCount > 0)
+	{
+		std::cout << "Particle updates: " << particles.updatesCount << ", ms per update: "
+			<< particles.updatesTime.asSeconds() * 1000.f / particles.updatesCount << std::endl;
+	}
+}
+
+// Renders the first level on the CPU without opening a window or the audio device and saves the last frame,
+// death bursts keep at least particlesCount particles alive
+int CaptureSoftwareFrames(const std::string& filePath, const int framesCount, const int particlesCount,
+	const int applesAmount)
+{
+	Game game;
+	game.applesAmountOverride = applesAmount;
+	SoftwareRenderer renderer;
+	if (!LoadSoftwareRendererResources(renderer))
+	{
+		std::cerr << "Failed to load resources from " << RESOURCES_PATH << std::endl;
+		return 1;
+	}
+
+	InitializeGame(game);
+	game.gameState = EGameState::Playing;
+
+	RenderSnapshot snapshot;
+	FillRenderSnapshot(game, snapshot);
+	InitializeSoftwareRenderer(renderer, SCREEN_WIDTH, SCREEN_HEIGHT);
+
+	sf::Clock clock;
+	for (int i = 0; i < framesCount; ++i)
+	{
+		KeepParticlesAlive(renderer.particles, std::max(0, particlesCount), {0.f, 0.f, SCREEN_WIDTH, SCREEN_HEIGHT});
+		DrawSoftwareFrame(renderer, snapshot, 1.f / SIMULATION_TICK_RATE);
+	}
+	const float seconds = clock.getElapsedTime().asSeconds();
+
+	const double pixelsCount = static_cast<double>(SCREEN_WIDTH) * SCREEN_HEIGHT * framesCount;
+	std::cout << "Apples: " << game.applesAmount << ", frames: " << framesCount << ", ms per frame: " << seconds * 1000.f / framesCount
+		<< ", Mpixels/s: " << pixelsCount / seconds / 1000000.0
+		<< ", live particles: " << renderer.particles.liveCount << std::endl;
+	PrintParticleUpdateTime(renderer.particles);
+
+	return SaveSoftwareFrame(renderer, filePath) ? 0 : 1;
+}
+
+bool HasArgument(const int argc, char* argv[], const std::string& argument)
+{
+	return std::find(argv + 1, argv + argc, argument) != argv + argc;
+}
+
+// Value following the named argument, defaultValue when it is missing
+int GetIntArgument(const int argc, char* argv[], const std::string& argument, const int defaultValue)
+{
+	char** found = std::find(argv + 1, argv + argc, argument);
+	return argv + argc - found > 1 ? std::atoi(found[1]) : defaultValue;
+}
+
+int main(int argc, char* argv[])
+{
+	StartupProfile startupProfile;
+	MarkStartupPhase(startupProfile, "Static initialization");
+
 	std::srand(static_cast<unsigned>(time(nullptr)));
 
+	// Without a packed archive the loose files under RESOURCES_PATH are used
+	if (OpenAssetArchive(GetMountedAssetArchive(), ASSET_ARCHIVE_PATH))
+		std::cout << "Assets are served from " << ASSET_ARCHIVE_PATH << std::endl;
+
+	if (argc >= 3 && std::string(argv[1]) == "--capture")
+	{
+		return CaptureSoftwareFrames(argv[2], argc >= 4 ? std::max(1, std::atoi(argv[3])) : 1,
+			argc >= 5 ? std::atoi(argv[4]) : 0, GetIntArgument(argc, argv, "--apples", 0));
+	}
+
+	// Quits after the first frame and fails when startup took longer than the budget, for catching startup regressions
+	const int startupBudgetMilliseconds = std::max(0, GetIntArgument(argc, argv, "--startup-budget-ms", 0));
+	MarkStartupPhase(startupProfile, "Archive mounting");
+
+	sf::RenderWindow window(sf::VideoMode(SCREEN_WIDTH, SCREEN_HEIGHT), GAME_TITLE);
+	window.setVerticalSyncEnabled(IS_VSYNC_ENABLED);
+	MarkStartupPhase(startupProfile, "Window creation");
+
+	// Assets decode on worker threads while this thread keeps the window responsive
+	AssetLoader assetLoader;
+	StartAssetLoading(assetLoader);
+	bool isWindowClosed = false;
+
+	while (!IsAssetLoadingFinished(assetLoader))
+	{
+		sf::Event event;
+		while (window.pollEvent(event))
+			isWindowClosed |= event.type == sf::Event::Closed;
+
+		DrawLoadingScreen(window, GetAssetLoadingProgress(assetLoader));
+		window.display();
+		sf::sleep(sf::milliseconds(LOADING_SCREEN_FRAME_MILLISECONDS));
+	}
+
+	if (!FinishAssetLoading(assetLoader))
+	{
+		for (const std::string& error : assetLoader.errors)
+			std::cerr << error << std::endl;
+		return 1;
+	}
+	MarkStartupPhase(startupProfile, "Asset loading");
+
+	// Warm starts skip image and sound decoding, compare against a run with the decoded cache directory removed
+	const DecodedAssetCacheStats& decodedAssetCacheStats = GetDecodedAssetCacheStats();
+	std::cout << "Assets loaded in " << assetLoader.loadingMicroseconds / 1000.f << " ms, decoded cache: "
+		<< decodedAssetCacheStats.hitsCount << " hits, " << decodedAssetCacheStats.missesCount << " misses" << std::endl;
+
+	if (isWindowClosed)
+		return 0;
+
+	// Everything below is served from the warmed caches, the atlas is uploaded while this thread owns the context
 	Game game;
-	LoadResources(game);
-	InitializeMenu(game);
+	Renderer renderer;
+	if (!LoadResources(game))
+	{
+		std::cerr << "Failed to load resources from " << RESOURCES_PATH << std::endl;
+		return 1;
+	}
+	MarkStartupPhase(startupProfile, "LoadResources");
+
+	if (!LoadRendererResources(renderer))
+	{
+		std::cerr << "Failed to load resources from " << RESOURCES_PATH << std::endl;
+		return 1;
+	}
+	MarkStartupPhase(startupProfile, "Atlas upload");
+	PrintTextureAtlasMemory(renderer.textureAtlas, std::cout);
+
+	game.applesAmountOverride = GetIntArgument(argc, argv, "--apples", 0);
 	InitializeGame(game);
+	MarkStartupPhase(startupProfile, "InitializeGame");
+
+	InitializeRenderer(renderer);
+	MarkStartupPhase(startupProfile, "InitializeRenderer");
+
+	// The interface font was the last asset to be acquired, from here on the source images the atlas resampled
+	// and assets replaced by later reloads are freed instead of living until exit
+	ReleaseLoadedAssets(assetLoader);
+
+	// Low latency polls input at the render frame rate and draws the newest tick without blending, late latching
+	// also turns the drawn player on presses the simulation has not consumed yet
+	renderer.stressParticlesCount = std::max(0, GetIntArgument(argc, argv, "--particles", 0));
+	renderer.isLateLatchEnabled = HasArgument(argc, argv, "--late-latch");
+	renderer.isLowLatencyEnabled = renderer.isLateLatchEnabled || HasArgument(argc, argv, "--low-latency");
 
+	// Loose files are watched so artists see their edits in the running game, a packed archive never changes
+	AssetWatcher assetWatcher;
+	if (GetMountedAssetArchive().entries.empty() && StartAssetWatcher(assetWatcher))
+		renderer.assetWatcher = &assetWatcher;
+	int appliedReloadsCount = 0;
+
+	// From here on the window is drawn only by the render thread, this one reads events and simulates
+	window.setActive(false);
+	SnapshotExchange snapshotExchange;
+	std::thread renderThread(RunRenderThread, std::ref(window), std::ref(renderer), std::ref(snapshotExchange));
+
+	RenderSnapshot snapshot;
 	float lastTime = game.clock.getElapsedTime().asSeconds();
 
-	while (window.isOpen())
+	// The simulation always advances in whole ticks, the render thread blends between the last two of them
+	const float simulationStep = 1.f / SIMULATION_TICK_RATE;
+	float accumulatedTime = 0.f;
+	int simulationStepsCount = 0;
+
+	FramePacer simulationPacer;
+	InitializeFramePacer(simulationPacer, renderer.isLowLatencyEnabled ? RENDER_FRAME_RATE : SIMULATION_TICK_RATE);
+
+	if (startupBudgetMilliseconds > 0)
+	{
+		FillRenderSnapshot(game, snapshot);
+		snapshot.time = GetTimeSinceProcessStart();
+		PublishRenderSnapshot(snapshotExchange, snapshot);
+
+		while (renderer.firstFrameMicroseconds < 0)
+			sf::sleep(sf::milliseconds(1));
+
+		game.isExitRequested = true;
+	}
+
+	while (!game.isExitRequested)
 	{
 		//Read events
 		sf::Event event;
 
+		if (IsStaticGameState(game) && !game.isRedrawRequired)
+		{
+			// Nothing on these screens changes until an event arrives, so block instead of ticking,
+			// while assets are watched a finished reload has to wake the loop as well
+			bool isEventRead = false;
+			if (renderer.assetWatcher)
+			{
+				while (!(isEventRead = window.pollEvent(event)) && assetWatcher.reloadsCount == appliedReloadsCount)
+					sf::sleep(sf::milliseconds(ASSET_RELOAD_POLL_MILLISECONDS));
+			}
+			else
+			{
+				isEventRead = window.waitEvent(event);
+			}
+
+			if (isEventRead)
+				HandleWindowEvent(event, game);
+
+			RestartFramePacer(simulationPacer);
+			lastTime = game.clock.getElapsedTime().asSeconds();
+			accumulatedTime = 0.f;
+		}
+		else
+		{
+			// Sleep before reading events, so input is sampled as close to the tick as possible
+			WaitForNextFrame(simulationPacer);
+		}
+
 		while (window.pollEvent(event))
+			HandleWindowEvent(event, game);
+
+		if (renderer.isLateLatchEnabled && game.gameState == EGameState::Playing)
+			LatchPlayerInput(renderer.latchedInput, game.input);
+
+		if (renderer.assetWatcher && assetWatcher.reloadsCount != appliedReloadsCount)
 		{
-			if (event.type == sf::Event::Closed)
-				window.close();
-
-			if (game.gameState == EGameState::Playing)
-				HandlePlayingEvents(event, window, game);
-			else if (game.gameState == EGameState::MainMenu)
-				HandleMainMenuInput(event, window, game);
-			else if (game.gameState == EGameState::Scoreboard)
-				HandleScoreboardInput(event, window, game);
+			appliedReloadsCount = assetWatcher.reloadsCount;
+			const std::vector<ReloadedAsset> soundBuffers = TakeReloadedAssets(assetWatcher, EAssetKind::SoundBuffer);
+			if (!soundBuffers.empty())
+				LoadResources(game);
+
+			game.isRedrawRequired = true;
 		}
 
 		//Calculate delta time
 		float currentTime = game.clock.getElapsedTime().asSeconds();
-		float deltaTime = currentTime - lastTime;
+		const sf::Time inputTime = GetTimeSinceProcessStart();
+		accumulatedTime += currentTime - lastTime;
 		lastTime = currentTime;
-		
-		switch (game.gameState)
+
+		int stepsCount = 0;
+		while (accumulatedTime >= simulationStep && stepsCount < MAX_SIMULATION_STEPS_PER_FRAME)
+		{
+			accumulatedTime -= simulationStep;
+			++stepsCount;
+
+			// Each tick sees the key events up to its own end, the last one of the batch everything read so far
+			const bool isLastStep = accumulatedTime < simulationStep || stepsCount == MAX_SIMULATION_STEPS_PER_FRAME;
+			TakeInputSnapshot(game.input, isLastStep ? inputTime : inputTime - sf::seconds(accumulatedTime), game.tickInput);
+			UpdateGame(game, simulationStep);
+		}
+		simulationStepsCount += stepsCount;
+
+		// After a long stall the backlog is dropped, catching it all up would only make the next frame later still
+		if (stepsCount == MAX_SIMULATION_STEPS_PER_FRAME)
+			accumulatedTime = std::min(accumulatedTime, simulationStep);
+
+		// Wakeups in between ticks only read input, there is no new state to draw
+		if ((stepsCount > 0 && !IsStaticGameState(game)) || game.isRedrawRequired)
 		{
-			case EGameState::MainMenu:
-				UpdateMainMenuGameState(window, game);
-				break;
-			case EGameState::Playing:
-				UpdatePlayingGameState(window, game, deltaTime);
-				break;
-			case EGameState::EndGame:
-				UpdateEndGameState(window, game, deltaTime);
-				break;
-			case EGameState::Scoreboard:
-				UpdateScoreboardState(window, game);
-				break;
-			default:
-				break;
+			FillRenderSnapshot(game, snapshot);
+			snapshot.time = GetTimeSinceProcessStart() - sf::seconds(accumulatedTime);
+			PublishRenderSnapshot(snapshotExchange, snapshot);
+			game.particleBursts.clear();
+			game.inputLatencySamples.clear();
+			game.isRedrawRequired = false;
 		}
 	}
 
+	StopRenderThread(snapshotExchange);
+	renderThread.join();
+	StopAssetWatcher(assetWatcher);
+	window.close();
+
+	if (renderer.firstFrameMicroseconds >= 0)
+		MarkStartupPhase(startupProfile, "First frame", sf::microseconds(renderer.firstFrameMicroseconds));
+	PrintStartupProfile(startupProfile, std::cout);
+
+	std::cout << "Simulation steps: " << simulationStepsCount << ", wakeups: " << simulationPacer.framesCount
+		<< ", missed deadlines: " << simulationPacer.missedDeadlinesCount << std::endl;
+	std::cout << "Paced render frames: " << renderer.framePacer.framesCount
+		<< ", missed deadlines: " << renderer.framePacer.missedDeadlinesCount << std::endl;
+	PrintInputLatency(renderer.inputLatency, simulationPacer.frameDuration, std::cout);
+	if (renderer.drawnFramesCount > 0)
+	{
+		std::cout << "Drawn frames: " << renderer.drawnFramesCount << ", average CPU ms per frame: "
+			<< renderer.framesTime.asSeconds() * 1000.f / renderer.drawnFramesCount << std::endl;
+	}
+	PrintParticleUpdateTime(renderer.particles);
+	std::cout << "Last frame draw calls: " << renderer.queue.drawCallsCount
+		<< ", state changes: " << renderer.queue.stateChangesCount
+		<< ", render scale: " << renderer.resolution.scale << std::endl;
+	std::cout << "Loaded from disk: " << GetFontCache().loadsCount << " fonts, " << GetImageCache().loadsCount
+		<< " images, " << GetSoundBufferCache().loadsCount << " sound buffers" << std::endl;
+
+	if (startupBudgetMilliseconds > 0 && IsStartupOverBudget(startupProfile, sf::milliseconds(startupBudgetMilliseconds)))
+	{
+		std::cerr << "Startup took " << GetStartupTime(startupProfile).asMilliseconds() << " ms, over the budget of "
+			<< startupBudgetMilliseconds << " ms" << std::endl;
+		return 1;
+	}
+
 	return 0;
 }
 
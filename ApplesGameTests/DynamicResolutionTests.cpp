@@ -0,0 +1,72 @@
+#include <algorithm>
+#include <functional>
+#include "Tests.h"
+#include "../ApplesGame/DynamicResolution.h"
+
+namespace ApplesGame
+{
+    namespace
+    {
+        constexpr float TARGET_FRAME_RATE = 60.f;
+
+        // Without an off-screen target the controller still tracks its scale, so no GPU is needed
+        void InitializeController(DynamicResolution& resolution)
+        {
+            resolution.targetFrameTime = 1.f / TARGET_FRAME_RATE;
+            resolution.averageFrameTime = 0.f;
+            resolution.framesSinceAdjustment = 0;
+            resolution.scale = DYNAMIC_RESOLUTION_MAX_SCALE;
+        }
+
+        // frameTime receives the frame index and the current scale, returns the lowest and highest scale seen
+        void FeedFrames(DynamicResolution& resolution, const int framesCount, const std::function<float(int, float)>& frameTime,
+                        float& minScale, float& maxScale)
+        {
+            minScale = resolution.scale;
+            maxScale = resolution.scale;
+            for (int i = 0; i < framesCount; ++i)
+            {
+                UpdateDynamicResolution(resolution, frameTime(i, resolution.scale));
+                minScale = std::min(minScale, resolution.scale);
+                maxScale = std::max(maxScale, resolution.scale);
+            }
+        }
+    }
+
+    void TestDynamicResolution()
+    {
+        DynamicResolution resolution;
+        float minScale = 0.f;
+        float maxScale = 0.f;
+
+        // Steady frames under budget never lower the scale
+        InitializeController(resolution);
+        FeedFrames(resolution, 600, [](int, float) { return 0.008f; }, minScale, maxScale);
+        CHECK(minScale == DYNAMIC_RESOLUTION_MAX_SCALE);
+
+        // Neither does jitter or an occasional spike while the average stays under budget
+        InitializeController(resolution);
+        FeedFrames(resolution, 600, [](const int frame, float)
+            {
+                if (frame % 60 == 59)
+                    return 0.04f;
+                return frame % 2 == 0 ? 0.004f : 0.013f;
+            }, minScale, maxScale);
+        CHECK(minScale == DYNAMIC_RESOLUTION_MAX_SCALE);
+
+        // Frames over budget lower the scale to where they fit, then it settles
+        InitializeController(resolution);
+        const auto heavyFrames = [](int, const float scale) { return 0.03f * scale * scale; };
+        FeedFrames(resolution, 600, heavyFrames, minScale, maxScale);
+        CHECK(resolution.scale < DYNAMIC_RESOLUTION_MAX_SCALE);
+        CHECK(resolution.scale > DYNAMIC_RESOLUTION_MIN_SCALE);
+        CHECK(heavyFrames(0, resolution.scale) < resolution.targetFrameTime);
+
+        FeedFrames(resolution, 600, heavyFrames, minScale, maxScale);
+        CHECK(maxScale - minScale == 0.f);
+
+        // And climbs back once the load is gone
+        FeedFrames(resolution, 600, [](int, const float scale) { return 0.008f * scale * scale; }, minScale, maxScale);
+        CHECK(resolution.scale == DYNAMIC_RESOLUTION_MAX_SCALE);
+    }
+}
@@ -0,0 +1,83 @@
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+#include "Tests.h"
+#include "../ApplesGame/PixelBlending.h"
+
+namespace ApplesGame
+{
+    namespace
+    {
+        constexpr int PIXELS_COUNT = 256;
+
+        // Plain sf::BlendAlpha math, x / 255 rounded to nearest never falls on a half since 255 is odd
+        uint8_t BlendChannel(const uint32_t source, const uint32_t destination, const uint32_t alpha)
+        {
+            return static_cast<uint8_t>((source * alpha + destination * (255 - alpha) + 127) / 255);
+        }
+
+        void BlendReferencePixel(uint8_t* destination, const uint8_t* source)
+        {
+            for (int channel = 0; channel < 3; ++channel)
+                destination[channel] = BlendChannel(source[channel], destination[channel], source[3]);
+
+            destination[3] = BlendChannel(255, destination[3], source[3]);
+        }
+    }
+
+    void TestPixelBlending()
+    {
+        std::vector<uint8_t> source(PIXELS_COUNT * 4);
+        std::vector<uint8_t> destination(PIXELS_COUNT * 4);
+        std::vector<uint8_t> span(PIXELS_COUNT * 4);
+        std::vector<uint8_t> scalar(PIXELS_COUNT * 4);
+        std::vector<uint8_t> reference(PIXELS_COUNT * 4);
+
+        // Each channel meets every source value under every alpha over every destination value
+        bool isSpanMatched = true;
+        bool isScalarMatched = true;
+        for (int alpha = 0; alpha < 256; ++alpha)
+        {
+            for (int value = 0; value < 256; ++value)
+            {
+                for (int i = 0; i < PIXELS_COUNT; ++i)
+                {
+                    const uint8_t sourcePixel[4] = {static_cast<uint8_t>(i), static_cast<uint8_t>(255 - i),
+                        static_cast<uint8_t>(i ^ 0x5A), static_cast<uint8_t>(alpha)};
+                    const uint8_t destinationPixel[4] = {static_cast<uint8_t>(value), static_cast<uint8_t>(value ^ 0xA5),
+                        static_cast<uint8_t>(255 - value), static_cast<uint8_t>(value)};
+                    std::copy(sourcePixel, sourcePixel + 4, &source[i * 4]);
+                    std::copy(destinationPixel, destinationPixel + 4, &destination[i * 4]);
+                }
+
+                span = destination;
+                scalar = destination;
+                reference = destination;
+                BlendPixelSpan(span.data(), source.data(), PIXELS_COUNT);
+                for (int i = 0; i < PIXELS_COUNT; ++i)
+                {
+                    BlendPixel(&scalar[i * 4], &source[i * 4]);
+                    BlendReferencePixel(&reference[i * 4], &source[i * 4]);
+                }
+
+                isSpanMatched &= span == reference;
+                isScalarMatched &= scalar == reference;
+            }
+        }
+
+        CHECK(isSpanMatched);
+        CHECK(isScalarMatched);
+
+        // Unaligned spans whose length is no multiple of four end on the scalar path
+        for (int count = 0; count < 12; ++count)
+        {
+            span = destination;
+            reference = destination;
+            BlendPixelSpan(&span[4], &source[8], count);
+            for (int i = 0; i < count; ++i)
+                BlendReferencePixel(&reference[4 + i * 4], &source[8 + i * 4]);
+
+            CHECK(span == reference);
+        }
+    }
+}
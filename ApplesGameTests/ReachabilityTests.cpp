@@ -0,0 +1,158 @@
+#include <cstdint>
+#include <deque>
+#include <random>
+#include <vector>
+#include "Tests.h"
+#include "../ApplesGame/Apple.h"
+#include "../ApplesGame/Constants.h"
+#include "../ApplesGame/Reachability.h"
+#include "../ApplesGame/Rock.h"
+
+namespace ApplesGame
+{
+    namespace
+    {
+        constexpr int LAYOUTS_COUNT = 200;
+
+        bool IsCellSet(const OccupancyGrid& grid, const std::vector<uint64_t>& cells, const int x, const int y)
+        {
+            return (cells[y * grid.wordsPerRow + x / 64] >> (x % 64)) & 1ull;
+        }
+
+        float GetCellCenter(const OccupancyGrid& grid, const int index)
+        {
+            return (static_cast<float>(index) + 0.5f) * grid.cellSize;
+        }
+
+        // Plain four-neighbour breadth-first search over the free cells, one byte per cell
+        std::vector<uint8_t> FindReachedCells(const OccupancyGrid& grid, const Position2D& start)
+        {
+            std::vector<uint8_t> reached(grid.width * grid.height, 0);
+            const int startX = static_cast<int>(start.x / grid.cellSize);
+            const int startY = static_cast<int>(start.y / grid.cellSize);
+            if (startX < 0 || startX >= grid.width || startY < 0 || startY >= grid.height ||
+                !IsCellSet(grid, grid.freeCells, startX, startY))
+            {
+                return reached;
+            }
+
+            std::deque<int> cells = {startY * grid.width + startX};
+            reached[cells.front()] = 1;
+            while (!cells.empty())
+            {
+                const int x = cells.front() % grid.width;
+                const int y = cells.front() / grid.width;
+                cells.pop_front();
+
+                const int neighbours[4][2] = {{x - 1, y}, {x + 1, y}, {x, y - 1}, {x, y + 1}};
+                for (const auto& neighbour : neighbours)
+                {
+                    const int nx = neighbour[0];
+                    const int ny = neighbour[1];
+                    if (nx < 0 || nx >= grid.width || ny < 0 || ny >= grid.height ||
+                        reached[ny * grid.width + nx] || !IsCellSet(grid, grid.freeCells, nx, ny))
+                    {
+                        continue;
+                    }
+
+                    reached[ny * grid.width + nx] = 1;
+                    cells.push_back(ny * grid.width + nx);
+                }
+            }
+
+            return reached;
+        }
+
+        // An apple counts as reached when the actor standing on any reached cell touches it
+        bool AreApplesTouched(const OccupancyGrid& grid, const std::vector<uint8_t>& reached,
+                              const std::vector<Apple>& apples, const float actorRadius)
+        {
+            for (const Apple& apple : apples)
+            {
+                bool isTouched = apple.isEaten;
+                for (int i = 0; i < grid.width * grid.height && !isTouched; ++i)
+                {
+                    const Circle cell = {{GetCellCenter(grid, i % grid.width), GetCellCenter(grid, i / grid.width)}, actorRadius};
+                    isTouched = reached[i] && CheckCircleCollision(cell, apple);
+                }
+
+                if (!isTouched)
+                    return false;
+            }
+
+            return true;
+        }
+    }
+
+    void TestReachability()
+    {
+        std::mt19937 random(26);
+        // Widths off multiples of 64 cells check the padding bits at the end of each row
+        std::uniform_real_distribution<float> fieldSize(60.f, 900.f);
+        std::uniform_int_distribution<int> count(0, 40);
+        OccupancyGrid grid;
+
+        for (int layout = 0; layout < LAYOUTS_COUNT; ++layout)
+        {
+            const float fieldWidth = fieldSize(random);
+            const float fieldHeight = fieldSize(random);
+            std::uniform_real_distribution<float> x(0.f, fieldWidth);
+            std::uniform_real_distribution<float> y(0.f, fieldHeight);
+            std::uniform_real_distribution<float> size(5.f, 80.f);
+
+            std::vector<Rock> rocks(count(random));
+            for (Rock& rock : rocks)
+            {
+                rock.position = {x(random), y(random)};
+                rock.size = {size(random), size(random)};
+            }
+
+            std::vector<Apple> apples(count(random) / 4 + 1);
+            for (Apple& apple : apples)
+            {
+                apple.position = {x(random), y(random)};
+                apple.radius = APPLE_RADIUS;
+                apple.isEaten = random() % 8 == 0;
+            }
+
+            const Circle actor = {{x(random), y(random)}, std::uniform_real_distribution<float>(2.f, 25.f)(random)};
+
+            // The same grid is reused across layouts of every size, as level generation does
+            const bool isReachable = AreApplesReachable(grid, actor, apples, rocks, fieldWidth, fieldHeight);
+            const std::vector<uint8_t> reached = FindReachedCells(grid, actor.position);
+
+            CHECK(grid.width == static_cast<int>(fieldWidth / REACHABILITY_CELL_SIZE));
+            CHECK(grid.height == static_cast<int>(fieldHeight / REACHABILITY_CELL_SIZE));
+
+            bool isEveryCellMatched = true;
+            bool isEveryFreeCellClear = true;
+            for (int cellY = 0; cellY < grid.height; ++cellY)
+            {
+                for (int cellX = 0; cellX < grid.width; ++cellX)
+                {
+                    isEveryCellMatched &= IsCellSet(grid, grid.reachedCells, cellX, cellY) == (reached[cellY * grid.width + cellX] != 0);
+                    if (!IsCellSet(grid, grid.freeCells, cellX, cellY))
+                        continue;
+
+                    // A free cell keeps the actor inside the field and off every rock
+                    const Circle cell = {{GetCellCenter(grid, cellX), GetCellCenter(grid, cellY)}, actor.radius};
+                    isEveryFreeCellClear &= cell.position.x >= actor.radius && cell.position.x <= fieldWidth - actor.radius &&
+                        cell.position.y >= actor.radius && cell.position.y <= fieldHeight - actor.radius;
+                    for (const Rock& rock : rocks)
+                        isEveryFreeCellClear &= !CheckCircleAndRectangleCollision(cell, rock);
+                }
+
+                // Padding past the last cell of a row is never set
+                for (int cellX = grid.width; cellX < grid.wordsPerRow * 64; ++cellX)
+                {
+                    isEveryFreeCellClear &= !IsCellSet(grid, grid.freeCells, cellX, cellY);
+                    isEveryCellMatched &= !IsCellSet(grid, grid.reachedCells, cellX, cellY);
+                }
+            }
+
+            CHECK(isEveryCellMatched);
+            CHECK(isEveryFreeCellClear);
+            CHECK(isReachable == AreApplesTouched(grid, reached, apples, actor.radius));
+        }
+    }
+}
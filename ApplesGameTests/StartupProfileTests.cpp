@@ -0,0 +1,31 @@
+#include <sstream>
+#include <string>
+#include "Tests.h"
+#include "../ApplesGame/StartupProfile.h"
+
+namespace ApplesGame
+{
+    void TestStartupProfile()
+    {
+        StartupProfile profile;
+        CHECK(GetStartupTime(profile) == sf::Time::Zero);
+        CHECK(IsStartupOverBudget(profile, sf::seconds(1.f)));
+
+        MarkStartupPhase(profile, "Window creation", sf::milliseconds(200));
+        MarkStartupPhase(profile, "Asset loading", sf::milliseconds(900));
+        MarkStartupPhase(profile, "First frame", sf::milliseconds(1500));
+        CHECK(GetStartupTime(profile) == sf::milliseconds(1500));
+
+        // The budget covers startup up to the last phase, a run that ends exactly on it still passes
+        CHECK(!IsStartupOverBudget(profile, sf::milliseconds(1500)));
+        CHECK(IsStartupOverBudget(profile, sf::milliseconds(1499)));
+
+        // Each phase is printed with its own duration, not the time since process start
+        std::ostringstream stream;
+        PrintStartupProfile(profile, stream);
+        const std::string report = stream.str();
+        CHECK(report.find("Asset loading") != std::string::npos);
+        CHECK(report.find("700.0") != std::string::npos);
+        CHECK(report.find("1500.0") != std::string::npos);
+    }
+}
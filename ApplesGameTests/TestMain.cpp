@@ -0,0 +1,41 @@
+﻿#include <iostream>
+#include "Tests.h"
+
+namespace ApplesGame
+{
+	namespace
+	{
+		int failedChecksCount = 0;
+	}
+
+	bool ReportCheck(const bool isPassed, const char* expression, const char* file, const int line)
+	{
+		if (!isPassed)
+		{
+			++failedChecksCount;
+			std::cerr << file << "(" << line << "): check failed: " << expression << std::endl;
+		}
+
+		return isPassed;
+	}
+}
+
+using namespace ApplesGame;
+
+// Runs every test, the exit code is 1 when any check failed
+int main()
+{
+	TestDynamicResolution();
+	TestPixelBlending();
+	TestReachability();
+	TestStartupProfile();
+
+	if (failedChecksCount > 0)
+	{
+		std::cerr << failedChecksCount << " checks failed" << std::endl;
+		return 1;
+	}
+
+	std::cout << "All tests passed" << std::endl;
+	return 0;
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+// Failed checks are printed and counted, the test run fails when any check failed
+#define CHECK(expression) ApplesGame::ReportCheck(static_cast<bool>(expression), #expression, __FILE__, __LINE__)
+
+namespace ApplesGame
+{
+    bool ReportCheck(bool isPassed, const char* expression, const char* file, int line);
+
+    void TestDynamicResolution();
+    void TestPixelBlending();
+    void TestReachability();
+    void TestStartupProfile();
+}
@@ -0,0 +1,51 @@
+﻿#include <algorithm>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../ApplesGame/AssetArchive.h"
+
+using namespace ApplesGame;
+
+// Packs every file under the resources directory into one archive, entries are named by their path relative to it:
+// AssetPacker <resources directory> <archive file>
+int main(int argc, char* argv[])
+{
+	if (argc != 3)
+	{
+		std::cerr << "Usage: AssetPacker <resources directory> <archive file>" << std::endl;
+		return 1;
+	}
+
+	const std::filesystem::path rootDirectory = argv[1];
+	std::vector<std::string> names;
+
+	std::error_code error;
+	for (std::filesystem::recursive_directory_iterator entry(rootDirectory, error), end; !error && entry != end; entry.increment(error))
+	{
+		if (entry->is_regular_file())
+			names.push_back(entry->path().lexically_relative(rootDirectory).generic_string());
+	}
+
+	if (error)
+	{
+		std::cerr << "Failed to list " << rootDirectory.string() << ": " << error.message() << std::endl;
+		return 1;
+	}
+
+	// Sorted so the same sources always produce the same archive
+	std::sort(names.begin(), names.end());
+
+	std::string writeError;
+	if (!WriteAssetArchive(argv[2], rootDirectory.generic_string(), names, writeError))
+	{
+		std::cerr << writeError << std::endl;
+		return 1;
+	}
+
+	for (const std::string& name : names)
+		std::cout << name << std::endl;
+	std::cout << "Packed " << names.size() << " files into " << argv[2] << std::endl;
+
+	return 0;
+}
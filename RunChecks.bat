@@ -0,0 +1,16 @@
+@echo off
+rem Runs ApplesGameTests and the ApplesGame startup budget check, the exit code is 1 when either fails
+rem Usage: RunChecks.bat [Configuration] [BudgetMs], after building Game.sln for x64
+set Configuration=%1
+if "%Configuration%"=="" set Configuration=Release
+set BudgetMs=%2
+if "%BudgetMs%"=="" set BudgetMs=1500
+
+ApplesGameTests\x64\%Configuration%\ApplesGameTests.exe || exit /b 1
+
+rem The game loads its resources relative to the project directory
+pushd ApplesGame
+x64\%Configuration%\ApplesGame.exe --startup-budget-ms %BudgetMs%
+set Result=%ERRORLEVEL%
+popd
+exit /b %Result%